@@ -1,75 +1,315 @@
 #include "colony.h"
-#include <iostream>
+#include "raymath.h"
+#include "log.h"
+#include "profiler.h"
+#include "job_system.h"
+#include <algorithm>
 
-Colony::Colony() : jurisdiction_radius(3.0f), research_level(0) {
+Colony::Colony(float sectRadius)
+    : unitPool(128),
+      sectPool(128),
+      sectRadius(sectRadius),
+      layoutVersion(0),
+      centroid({0.0f, 0.0f}),
+      jurisdiction_radius(0.0f),
+      positionSumX(0.0),
+      positionSumY(0.0),
+      radiusSlack(0.0f),
+      averageDevelopment(0.0f),
+      research_level(0)
+{
     // Initialize other members as needed
 }
 
 Colony::~Colony() {
-    for (auto sect : sects) {
-        delete sect;
-    }
+    // Units and sects own nothing but their records in the UnitStore. Those go
+    // in one bulk removal, and then both pools are dropped block by block
+    // without visiting a single unit or sect.
+    UnitStore::Global().RemoveSects(sectIds);
+    unitPool.Discard();
+    sectPool.Discard();
+}
+
+void Colony::ReserveSects(size_t count) {
+    sectPool.Reserve(count);
+    unitPool.Reserve(count);  // Only the core unit of a new sect is materialized
+    sects.reserve(sects.size() + count);
+    sectHandles.reserve(sectHandles.size() + count);
 }
 
-void Colony::AddSect(Sect* sect) {
+Sect* Colony::AddSect(Vector2 position) {
+    Pool<Sect>::Handle handle = sectPool.Create(unitPool, sectRadius);
+    Sect* sect = sectPool.Get(handle);
+    sect->SetPosition(position);
+    sectGrid.Insert(static_cast<uint32_t>(sects.size()), position);
     sects.push_back(sect);
-    std::cout << "New sect added to the colony." << std::endl;
-    CalculateCentroid();
+    sectHandles.push_back(handle);
+    sectIds.Insert(sect->GetStoreId());
+    layoutVersion++;
+    LOG_DEBUG("New sect added to the colony.");
+
+    Vector2 previous = centroid;
+    positionSumX += position.x;
+    positionSumY += position.y;
+    UpdateFootprint(previous, &position, sect->GetRadius(), false);
+    return sect;
+}
+
+void Colony::RemoveSect(Sect* sect) {
+    size_t index = FindSectIndex(sect);
+    if (index == sects.size()) {
+        return;
+    }
+
+    transport.RemoveNode(sect->GetStoreId());
+
+    // Swap-remove, the sect order carries no meaning
+    size_t last = sects.size() - 1;
+    Pool<Sect>::Handle handle = sectHandles[index];
+    sectGrid.Remove(static_cast<uint32_t>(index), sect->GetPosition());
+    if (index != last) {
+        sectGrid.Rename(static_cast<uint32_t>(last), static_cast<uint32_t>(index), sects[last]->GetPosition());
+    }
+    sects[index] = sects.back();
+    sectHandles[index] = sectHandles.back();
+    sects.pop_back();
+    sectHandles.pop_back();
+
+    Vector2 position = sect->GetPosition();
+    Vector2 previous = centroid;
+    bool shrunk = IsOnBoundary(position, sect->GetRadius());
+    positionSumX -= position.x;
+    positionSumY -= position.y;
+    UpdateFootprint(previous, nullptr, 0.0f, shrunk);
+
+    auto shipper = std::find(shippers.begin(), shippers.end(), sect);
+    if (shipper != shippers.end()) {
+        shippers.erase(shipper);
+    }
+    CancelUnroutedShipments(sect);
+
+    sectIds.Erase(sect->GetStoreId());
+    sectPool.Destroy(handle);
+    layoutVersion++;
+    LOG_DEBUG("Sect removed from the colony.");
 }
 
+void Colony::MoveSect(Sect* sect, Vector2 position) {
+    Vector2 from = sect->GetPosition();
+    Vector2 previous = centroid;
+    bool shrunk = IsOnBoundary(from, sect->GetRadius());
+
+    size_t index = FindSectIndex(sect);
+    if (index == sects.size()) {
+        return;
+    }
+    sectGrid.Move(static_cast<uint32_t>(index), from, position);
+    layoutVersion++;
+
+    sect->SetPosition(position);
+    transport.MoveNode(sect->GetStoreId(), position);
+    positionSumX += position.x - from.x;
+    positionSumY += position.y - from.y;
+    UpdateFootprint(previous, &position, sect->GetRadius(), shrunk);
+}
+
+size_t Colony::FindSectIndex(const Sect* sect) const {
+    // Only the grid cell under the sect can hold its index
+    size_t index = sects.size();
+    Vector2 position = sect->GetPosition();
+    sectGrid.ForEachInRect(position, position, [this, sect, &index](const SpatialGrid::Entry& entry) {
+        if (sects[entry.id] == sect) {
+            index = entry.id;
+        }
+    });
+    return index;
+}
 
 void Colony::BuildRoad(Sect* sect_a, Sect* sect_b) {
-    roads.push_back(std::make_pair(sect_a, sect_b));
-    std::cout << "New road built between sects." << std::endl;
+    transport.AddRoad(sect_a->GetStoreId(), sect_a->GetPosition(), sect_b->GetStoreId(), sect_b->GetPosition());
+    LOG_DEBUG("New road built between sects.");
+}
+
+void Colony::RemoveRoad(Sect* sect_a, Sect* sect_b) {
+    if (transport.RemoveRoad(sect_a->GetStoreId(), sect_b->GetStoreId())) {
+        LOG_DEBUG("Road between sects removed.");
+        CancelUnroutedShipments(nullptr);
+    }
+}
+
+bool Colony::AddShipment(Sect* from, Sect* to, ResourceId id, float amountPerTick) {
+    if (from == to || !transport.FindRoute(from->GetStoreId(), to->GetStoreId()).IsReachable()) {
+        LOG_WARNING("No road route for a shipment between sects.");
+        return false;
+    }
+    if (!from->AddShipment(to, id, amountPerTick)) {
+        return false;
+    }
+    if (from->GetShipmentCount() == 1) {
+        shippers.push_back(from);
+    }
+    return true;
+}
+
+void Colony::CancelUnroutedShipments(const Sect* removed) {
+    // Routes that survived the change are still cached, so this is mostly lookups
+    size_t kept = 0;
+    for (Sect* sect : shippers) {
+        size_t left = sect->RemoveShipmentsIf([this, sect, removed](const ResourceTransfer& shipment) {
+            return shipment.to == removed ||
+                   !transport.FindRoute(sect->GetStoreId(), shipment.to->GetStoreId()).IsReachable();
+        });
+        if (left > 0) {
+            shippers[kept++] = sect;
+        }
+    }
+    shippers.resize(kept);
 }
 
 void Colony::ManageResources() {
-    // TODO: Implement resource management logic
-    std::cout << "Colony resources managed." << std::endl;
+    // Colony-wide totals, one vector add per sect
+    available_resources.Clear();
+    float development = 0.0f;
+    for (const auto& sect : sects) {
+        available_resources += sect->GetResources();
+        development += sect->GetDevelopment();
+    }
+    averageDevelopment = sects.empty() ? 0.0f : development / sects.size();
+}
+
+float Colony::TransferResource(Sect* from, Sect* to, ResourceId id, float amount) {
+    return ::TransferResource(from->GetResources(), to->GetResources(), id, amount);
 }
 
 void Colony::UnlockResearch() {
     research_level++;
-    std::cout << "Colony research level increased to " << research_level << std::endl;
+    LOG_INFO("Colony research level increased to %d", research_level);
     // TODO: Implement unlocking of new technologies based on research level
 }
 
-void Colony::Draw(float scale) {
-    // Translate the drawing to center the colony
-//    Vector2 screenCenter = { GetScreenWidth() / 2.0f, GetScreenHeight() / 2.0f };
-//    Vector2 translation = { screenCenter.x - centroid.x, screenCenter.y - centroid.y };
+size_t Colony::CountActiveUnits(UnitType type) const {
+    return UnitStore::Global().CountActiveUnits(type, sectIds);
+}
 
-    // Draw each sect inside the colony
-    for (const auto& sect : sects) {
-        Vector2 worldPos = sect->GetPosition();  // This should already be in world coordinates
-        sect->DrawInColonyView(worldPos, scale);
+void Colony::Update() {
+    PROFILE_SCOPE("Colony::Update");
+
+    // Sects only touch their own state while ticking, so they run in parallel
+    JobSystem::Global().ParallelFor(sects.size(), SECT_TICK_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            sects[i]->Update();
+        }
+    });
+}
+
+void Colony::ApplyTransfers() {
+    PROFILE_SCOPE("Colony::ApplyTransfers");
+
+    // One thread, shippers in a fixed order: the result does not depend on the thread count
+    for (Sect* sect : shippers) {
+        sect->ApplyQueuedTransfers();
     }
 }
 
-void Colony::CalculateCentroid() {
-    // If there are no sects, return zero vector
+void Colony::CollectVisibleSects(const SpatialGrid& sectGrid, size_t sectCount, float coreRadius, float scale,
+                                Rectangle visible, size_t firstIndex, std::vector<size_t>& result) {
+    // Widen the view by how far a sect is drawn beyond its position, then ask the grid.
+    // Sorting keeps the overlap order of neighbouring sects stable from frame to frame.
+    size_t first = result.size();
+    float reach = coreRadius * scale * Sect::COLONY_VIEW_REACH;
+    sectGrid.ForEachInRect({visible.x - reach, visible.y - reach},
+                           {visible.x + visible.width + reach, visible.y + visible.height + reach},
+                           [&](const SpatialGrid::Entry& entry) {
+        if (entry.id < sectCount) {
+            result.push_back(firstIndex + entry.id);
+        }
+    });
+    std::sort(result.begin() + first, result.end());
+}
+
+Sect* Colony::FindSectAt(Vector2 worldPosition, float scale) const {
     if (sects.empty()) {
-        centroid = { 0.0f, 0.0f };
+        return nullptr;
     }
 
-    // If there's only one sect, return its position
-    if (sects.size() == 1) {
-        centroid = sects[0]->GetPosition();
+    // Every sect has the same core radius
+    uint32_t index;
+    if (!sectGrid.FindNearest(worldPosition, sects.front()->GetRadius() * scale, index)) {
+        return nullptr;
     }
+    return sects[index];
+}
 
-    // Calculate the average of all sect positions
-    float sumX = 0.0f;
-    float sumY = 0.0f;
+void Colony::FindSectsInRadius(Vector2 center, float radius, std::vector<Sect*>& result) const {
+    sectGrid.ForEachInRadius(center, radius, [this, &result](const SpatialGrid::Entry& entry) {
+        result.push_back(sects[entry.id]);
+    });
+}
 
+void Colony::CalculateCentroid() {
+    PROFILE_SCOPE("Colony::CalculateCentroid");
+
+    // Rebuild the running sums from scratch, dropping accumulated rounding
+    positionSumX = 0.0;
+    positionSumY = 0.0;
     for (const auto& sect : sects) {
         Vector2 sectPos = sect->GetPosition();
-        sumX += sectPos.x;
-        sumY += sectPos.y;
+        positionSumX += sectPos.x;
+        positionSumY += sectPos.y;
     }
 
-    // Update colony position with the calculated centroid
-    centroid.x = sumX / static_cast<float>(sects.size());
-    centroid.y = sumY / static_cast<float>(sects.size());
+    UpdateCentroid();
+    CalculateRadius();
+}
 
+void Colony::UpdateCentroid() {
+    // If there are no sects, return zero vector
+    if (sects.empty()) {
+        centroid = { 0.0f, 0.0f };
+        return;
+    }
+
+    centroid.x = static_cast<float>(positionSumX / sects.size());
+    centroid.y = static_cast<float>(positionSumY / sects.size());
+}
+
+void Colony::CalculateRadius() {
+    jurisdiction_radius = 0.0f;
+    for (const auto& sect : sects) {
+        jurisdiction_radius = std::max(jurisdiction_radius,
+                                       Vector2Distance(centroid, sect->GetPosition()) + sect->GetRadius());
+    }
+    radiusSlack = 0.0f;
+}
+
+bool Colony::IsOnBoundary(Vector2 position, float sectRadius) const {
+    // Could this sect be the one that sets the radius?
+    return Vector2Distance(position, centroid) + sectRadius >= jurisdiction_radius - radiusSlack;
 }
 
+// Called after the running sums changed. `position` is a sect now in the colony,
+// or nullptr if none was added; `shrunk` is set when a sect on the edge left.
+void Colony::UpdateFootprint(Vector2 previousCentroid, const Vector2* position, float sectRadius, bool shrunk) {
+    UpdateCentroid();
+
+    if (sects.empty()) {
+        positionSumX = 0.0;
+        positionSumY = 0.0;
+        jurisdiction_radius = 0.0f;
+        radiusSlack = 0.0f;
+        return;
+    }
+
+    // Every sect is at most `drift` further from the new centroid than from the old one
+    float drift = Vector2Distance(previousCentroid, centroid);
+    jurisdiction_radius += drift;
+    radiusSlack += drift;
+    if (position) {
+        jurisdiction_radius = std::max(jurisdiction_radius, Vector2Distance(*position, centroid) + sectRadius);
+    }
+
+    // Losing a sect on the edge can shrink the footprint by more than the slack tracks
+    if (shrunk || radiusSlack > jurisdiction_radius * RADIUS_SLACK_FRACTION) {
+        CalculateRadius();
+    }
+}
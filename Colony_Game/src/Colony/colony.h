@@ -5,36 +5,90 @@
 #include <vector>
 #include <utility>
 #include "sect.h"
+#include "spatial_grid.h"
+#include "transport_network.h"
 
 class Colony {
 public:
-    Colony();
+    explicit Colony(float sectRadius);  // Core radius of every sect, PlanetConfig::GetSectRadius
     ~Colony();
 
-    void AddSect(Sect* sect);
+    Colony(const Colony&) = delete;
+    Colony& operator=(const Colony&) = delete;
+
+    // Sects and their units are allocated from the colony's pools
+    Sect* AddSect(Vector2 position);
+    void RemoveSect(Sect* sect);  // Not while the colony ticks
+    void MoveSect(Sect* sect, Vector2 position);
+    void ReserveSects(size_t count);
     void BuildRoad(Sect* sect_a, Sect* sect_b);
+    void RemoveRoad(Sect* sect_a, Sect* sect_b);  // Cancels shipments left without a route
+    // Standing shipment between two of the colony's sects, sent every tick. False
+    // if no road route connects them or `from` has Sect::MAX_SHIPMENTS already.
+    bool AddShipment(Sect* from, Sect* to, ResourceId id, float amountPerTick);
     void ManageResources();
+    float TransferResource(Sect* from, Sect* to, ResourceId id, float amount);
     void UnlockResearch();
-    void Draw(float scale);
-    void CalculateCentroid();
+    void Update();          // Ticks the sects, in parallel
+    void ApplyTransfers();  // Merge phase: transfers the sects queued, in a fixed sect order
+    static void DrawImpostor(Vector2 centroid, float radius, float development);  // Whole colony at planet zoom
+    // Appends firstIndex + id, in id order, for every sect in sectGrid whose drawing
+    // at `scale` reaches into visible; ids at or past sectCount are skipped
+    static void CollectVisibleSects(const SpatialGrid& sectGrid, size_t sectCount, float coreRadius, float scale,
+                                    Rectangle visible, size_t firstIndex, std::vector<size_t>& result);
+    Sect* FindSectAt(Vector2 worldPosition, float scale = 1.0f) const;  // nullptr if no sect covers the point
+    void FindSectsInRadius(Vector2 center, float radius, std::vector<Sect*>& result) const;  // Appends to result
+    void CalculateCentroid();  // Exact full pass; adds, removes and moves keep both up to date
 
     // Getters
     Vector2 GetCentroid() const {return centroid;}
-    float GetRadius() const {return jurisdiction_radius;}
+    float GetRadius() const {return jurisdiction_radius;}  // Encloses every sect's core around the centroid
     const std::vector<Sect*>& GetSects() const {return sects;}
+    const SpatialGrid& GetSectGrid() const {return sectGrid;}  // Ids are indices into GetSects()
+    uint64_t GetLayoutVersion() const {return layoutVersion;}  // Changes whenever a sect is added, removed or moved
+    const ResourceVector& GetAvailableResources() const {return available_resources;}
+    float GetAverageDevelopment() const {return averageDevelopment;}
+    TransportNetwork& GetTransportNetwork() {return transport;}  // Roads by sect store id, FindRoute
+    const TransportNetwork& GetTransportNetwork() const {return transport;}
+
+    // Popcount queries over the sects' unit status bitsets
+    size_t CountActiveUnits(UnitType type) const;
 
 
 
 private:
+    Pool<Unit> unitPool;            // Declared before sectPool so it outlives the sects
+    Pool<Sect> sectPool;
+    float sectRadius;
     std::vector<Sect*> sects;
+    std::vector<Pool<Sect>::Handle> sectHandles;  // Pool handles of the sects above
+    UnitStore::SectSet sectIds;     // Store ids of the sects above
+    SpatialGrid sectGrid;           // Positions of the sects above, by index
+    uint64_t layoutVersion;
     Vector2 centroid;
     float jurisdiction_radius;
-    std::map<std::string, int> available_resources;
-    std::vector<std::pair<Sect*, Sect*>> roads;
-    int research_level;
 
+    // Running sums behind the centroid. The radius is an upper bound that
+    // loosens by however far the centroid drifts; once the drift is a sizeable
+    // part of the radius it is measured again.
+    double positionSumX;
+    double positionSumY;
+    float radiusSlack;
+    static constexpr float RADIUS_SLACK_FRACTION = 0.25f;
+
+    size_t FindSectIndex(const Sect* sect) const;  // sects.size() if not in this colony
+    bool IsOnBoundary(Vector2 position, float sectRadius) const;
+    void UpdateFootprint(Vector2 previousCentroid, const Vector2* position, float sectRadius, bool shrunk);
+    void UpdateCentroid();
+    void CalculateRadius();
+    ResourceVector available_resources;  // Sum of all sect resources
+    float averageDevelopment;            // Mean over the sects, drawn by the impostor
+    TransportNetwork transport;          // Roads between the sects above
+    std::vector<Sect*> shippers;         // Sects with standing shipments, in the order they got the first
+    void CancelUnroutedShipments(const Sect* removed);  // After roads or a sect went away
+    int research_level;
 
-    // Add transport_network when implemented
+    static constexpr size_t SECT_TICK_GRAIN = 256;  // Sects per parallel job
 };
 
 #endif // COLONY_H
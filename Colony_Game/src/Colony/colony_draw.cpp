@@ -0,0 +1,14 @@
+#include "colony.h"
+#include "raymath.h"
+
+void Colony::DrawImpostor(Vector2 centroid, float radius, float development) {
+    // One disc over the colony's footprint, greener the more developed its sects are
+    float t = Clamp(development, 0.0f, 1.0f);
+    Color color = {
+        static_cast<unsigned char>(LIGHTGRAY.r + (GREEN.r - LIGHTGRAY.r) * t),
+        static_cast<unsigned char>(LIGHTGRAY.g + (GREEN.g - LIGHTGRAY.g) * t),
+        static_cast<unsigned char>(LIGHTGRAY.b + (GREEN.b - LIGHTGRAY.b) * t),
+        153  // 60% opaque
+    };
+    DrawCircleV(centroid, radius, color);
+}
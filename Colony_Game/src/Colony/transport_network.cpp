@@ -0,0 +1,258 @@
+#include "transport_network.h"
+#include "raymath.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cmath>
+
+static const uint32_t NO_NODE = 0xFFFFFFFFu;
+
+void TransportNetwork::AddRoad(NodeId a, Vector2 positionA, NodeId b, Vector2 positionB) {
+    uint64_t key = RoadKey(a, b);
+    if (a == b || roadIndex.count(key)) {
+        return;
+    }
+
+    nodes[a].position = positionA;
+    nodes[a].roadCount++;
+    nodes[b].position = positionB;
+    nodes[b].roadCount++;
+
+    Road road = {a, b, Vector2Distance(positionA, positionB)};
+    roadIndex[key] = roads.size();
+    roads.push_back(road);
+    graphDirty = true;
+    DropRoutesShortenedBy(road);
+}
+
+bool TransportNetwork::RemoveRoad(NodeId a, NodeId b) {
+    auto it = roadIndex.find(RoadKey(a, b));
+    if (it == roadIndex.end()) {
+        return false;
+    }
+
+    // Swap-remove, the road order carries no meaning
+    size_t index = it->second;
+    roadIndex.erase(it);
+    if (index != roads.size() - 1) {
+        roads[index] = roads.back();
+        roadIndex[RoadKey(roads[index].a, roads[index].b)] = index;
+    }
+    roads.pop_back();
+
+    for (NodeId node : {a, b}) {
+        auto found = nodes.find(node);
+        if (--found->second.roadCount == 0) {
+            nodes.erase(found);
+        }
+    }
+    graphDirty = true;
+    DropRoutesThrough(a, b);
+    return true;
+}
+
+void TransportNetwork::RemoveNode(NodeId node) {
+    if (!nodes.count(node)) {
+        return;
+    }
+
+    std::vector<NodeId> neighbours;
+    for (const Road& road : roads) {
+        if (road.a == node || road.b == node) {
+            neighbours.push_back(road.a == node ? road.b : road.a);
+        }
+    }
+    for (NodeId neighbour : neighbours) {
+        RemoveRoad(node, neighbour);
+    }
+}
+
+void TransportNetwork::MoveNode(NodeId node, Vector2 position) {
+    auto it = nodes.find(node);
+    if (it == nodes.end()) {
+        return;
+    }
+
+    it->second.position = position;
+    for (Road& road : roads) {
+        if (road.a == node || road.b == node) {
+            road.length = Vector2Distance(nodes[road.a].position, nodes[road.b].position);
+        }
+    }
+    // Lengths changed in both directions, any route may be stale
+    graphDirty = true;
+    routes.clear();
+}
+
+void TransportNetwork::DropRoutesThrough(NodeId a, NodeId b) {
+    // Routes that never used the road are still shortest without it
+    for (auto it = routes.begin(); it != routes.end();) {
+        const std::vector<NodeId>& path = it->second.nodes;
+        bool uses = false;
+        for (size_t i = 1; i < path.size() && !uses; i++) {
+            uses = (path[i - 1] == a && path[i] == b) || (path[i - 1] == b && path[i] == a);
+        }
+        it = uses ? routes.erase(it) : std::next(it);
+    }
+}
+
+void TransportNetwork::DropRoutesShortenedBy(const Road& road) {
+    // Every road is as long as the straight line between its sects, so no
+    // route through the new road can beat the straight lines to and from it
+    Vector2 positionA = nodes[road.a].position;
+    Vector2 positionB = nodes[road.b].position;
+    for (auto it = routes.begin(); it != routes.end();) {
+        const Route& route = it->second;
+        auto from = nodes.find(route.nodes.empty() ? NO_NODE : route.nodes.front());
+        auto to = nodes.find(route.nodes.empty() ? NO_NODE : route.nodes.back());
+        bool stale = true;  // An unreachable pair may just have been connected
+        if (route.length == 0.0f) {
+            stale = false;  // A sect to itself
+        } else if (from != nodes.end() && to != nodes.end()) {
+            float bound = road.length + std::min(
+                Vector2Distance(from->second.position, positionA) + Vector2Distance(positionB, to->second.position),
+                Vector2Distance(from->second.position, positionB) + Vector2Distance(positionA, to->second.position));
+            stale = bound < route.length;
+        }
+        it = stale ? routes.erase(it) : std::next(it);
+    }
+}
+
+void TransportNetwork::BuildGraph() {
+    PROFILE_SCOPE("TransportNetwork::BuildGraph");
+
+    // Local indices in order of first appearance
+    localIndex.clear();
+    localIds.clear();
+    localPositions.clear();
+    auto local = [this](NodeId id) {
+        auto inserted = localIndex.emplace(id, static_cast<uint32_t>(localIds.size()));
+        if (inserted.second) {
+            localIds.push_back(id);
+            localPositions.push_back(nodes[id].position);
+        }
+        return inserted.first->second;
+    };
+    std::vector<uint32_t> ends(roads.size() * 2);
+    for (size_t i = 0; i < roads.size(); i++) {
+        ends[2 * i] = local(roads[i].a);
+        ends[2 * i + 1] = local(roads[i].b);
+    }
+
+    // Count each node's roads, prefix-sum them into offsets, then fill both directions
+    size_t nodeCount = localIds.size();
+    edgeOffsets.assign(nodeCount + 1, 0);
+    for (uint32_t end : ends) {
+        edgeOffsets[end + 1]++;
+    }
+    for (size_t i = 0; i < nodeCount; i++) {
+        edgeOffsets[i + 1] += edgeOffsets[i];
+    }
+    edgeTargets.resize(ends.size());
+    edgeLengths.resize(ends.size());
+    std::vector<uint32_t> cursor(edgeOffsets.begin(), edgeOffsets.end() - 1);
+    for (size_t i = 0; i < roads.size(); i++) {
+        uint32_t a = ends[2 * i];
+        uint32_t b = ends[2 * i + 1];
+        edgeTargets[cursor[a]] = b;
+        edgeLengths[cursor[a]++] = roads[i].length;
+        edgeTargets[cursor[b]] = a;
+        edgeLengths[cursor[b]++] = roads[i].length;
+    }
+
+    lengthSoFar.resize(nodeCount);
+    parent.resize(nodeCount);
+    seenStamp.assign(nodeCount, 0);
+    closedStamp.assign(nodeCount, 0);
+    searchStamp = 0;
+    graphDirty = false;
+}
+
+const TransportNetwork::Route& TransportNetwork::FindRoute(NodeId from, NodeId to) {
+    uint64_t key = RouteKey(from, to);
+    auto it = routes.find(key);
+    if (it != routes.end()) {
+        return it->second;
+    }
+
+    if (routes.size() >= MAX_CACHED_ROUTES) {
+        routes.clear();
+    }
+    Route& route = routes[key];
+    Search(from, to, route);
+    return route;
+}
+
+void TransportNetwork::Search(NodeId from, NodeId to, Route& route) {
+    PROFILE_SCOPE("TransportNetwork::Search");
+
+    route.length = INFINITY;
+    route.nodes.clear();
+    if (from == to) {
+        route.length = 0.0f;
+        route.nodes.push_back(from);
+        return;
+    }
+
+    if (graphDirty) {
+        BuildGraph();
+    }
+    auto fromIt = localIndex.find(from);
+    auto toIt = localIndex.find(to);
+    if (fromIt == localIndex.end() || toIt == localIndex.end()) {
+        return;  // A sect without roads reaches nothing
+    }
+    uint32_t start = fromIt->second;
+    uint32_t goal = toIt->second;
+    Vector2 goalPosition = localPositions[goal];
+
+    // Stamps mark this search's nodes, so the scratch arrays are never cleared
+    if (++searchStamp == 0) {
+        std::fill(seenStamp.begin(), seenStamp.end(), 0);
+        std::fill(closedStamp.begin(), closedStamp.end(), 0);
+        searchStamp = 1;
+    }
+
+    auto later = [](const OpenEntry& x, const OpenEntry& y) { return x.estimate > y.estimate; };
+    open.clear();
+    lengthSoFar[start] = 0.0f;
+    parent[start] = NO_NODE;
+    seenStamp[start] = searchStamp;
+    open.push_back({Vector2Distance(localPositions[start], goalPosition), start});
+
+    // The straight-line estimate never overshoots and obeys the triangle
+    // inequality, so a node's first settling is final
+    while (!open.empty()) {
+        std::pop_heap(open.begin(), open.end(), later);
+        uint32_t node = open.back().node;
+        open.pop_back();
+        if (closedStamp[node] == searchStamp) {
+            continue;  // Stale entry, the node was settled through a shorter route
+        }
+        closedStamp[node] = searchStamp;
+        if (node == goal) {
+            break;
+        }
+
+        for (uint32_t edge = edgeOffsets[node]; edge < edgeOffsets[node + 1]; edge++) {
+            uint32_t next = edgeTargets[edge];
+            float length = lengthSoFar[node] + edgeLengths[edge];
+            if (closedStamp[next] == searchStamp || (seenStamp[next] == searchStamp && length >= lengthSoFar[next])) {
+                continue;
+            }
+            seenStamp[next] = searchStamp;
+            lengthSoFar[next] = length;
+            parent[next] = node;
+            open.push_back({length + Vector2Distance(localPositions[next], goalPosition), next});
+            std::push_heap(open.begin(), open.end(), later);
+        }
+    }
+
+    if (closedStamp[goal] != searchStamp) {
+        return;
+    }
+    route.length = lengthSoFar[goal];
+    for (uint32_t node = goal; node != NO_NODE; node = parent[node]) {
+        route.nodes.push_back(localIds[node]);
+    }
+    std::reverse(route.nodes.begin(), route.nodes.end());
+}
@@ -0,0 +1,97 @@
+#ifndef TRANSPORT_NETWORK_H
+#define TRANSPORT_NETWORK_H
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Roads between sects and shortest routes over them.
+//
+// Nodes are sect store ids, which stay put when other sects are removed.
+// Roads are kept as an edge list and compressed into CSR adjacency arrays
+// the first time a route is searched after a change, so a search walks
+// contiguous memory. Routes are found with A* on road length, guided by the
+// straight-line distance, and cached per (from, to) pair. Changes only drop
+// the cached routes they can affect: a removed road drops the routes that
+// use it, a new road those it could shorten.
+//
+// Not thread-safe: FindRoute fills the cache, so route from one thread.
+class TransportNetwork {
+public:
+    typedef uint32_t NodeId;  // Sect store id
+
+    struct Route {
+        float length;                // Infinity when to cannot be reached
+        std::vector<NodeId> nodes;   // from ... to, empty when unreachable
+        bool IsReachable() const { return !nodes.empty(); }
+    };
+
+    TransportNetwork() : graphDirty(false), searchStamp(0) {}
+
+    // Roads run straight between the two sect positions. Adding an existing road does nothing.
+    void AddRoad(NodeId a, Vector2 positionA, NodeId b, Vector2 positionB);
+    bool RemoveRoad(NodeId a, NodeId b);  // False if there was no such road
+    void RemoveNode(NodeId node);         // Every road of a removed sect
+    void MoveNode(NodeId node, Vector2 position);
+    bool HasRoad(NodeId a, NodeId b) const { return roadIndex.count(RoadKey(a, b)) != 0; }
+    size_t GetRoadCount() const { return roads.size(); }
+
+    // Shortest route by road length. Valid until the network changes or the next FindRoute.
+    const Route& FindRoute(NodeId from, NodeId to);
+    size_t GetCachedRouteCount() const { return routes.size(); }
+    void ClearRouteCache() { routes.clear(); }
+
+private:
+    struct Road {
+        NodeId a;
+        NodeId b;
+        float length;
+    };
+    struct Node {
+        Vector2 position;
+        uint32_t roadCount;
+    };
+    struct OpenEntry {
+        float estimate;  // Length so far plus straight-line distance to the goal
+        uint32_t node;
+    };
+
+    static uint64_t RoadKey(NodeId a, NodeId b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+    static uint64_t RouteKey(NodeId from, NodeId to) { return (static_cast<uint64_t>(from) << 32) | to; }
+
+    void BuildGraph();
+    void Search(NodeId from, NodeId to, Route& route);
+    void DropRoutesThrough(NodeId a, NodeId b);
+    void DropRoutesShortenedBy(const Road& road);
+
+    // Source of truth
+    std::vector<Road> roads;
+    std::unordered_map<uint64_t, size_t> roadIndex;  // RoadKey -> index into roads
+    std::unordered_map<NodeId, Node> nodes;          // Sects with at least one road
+
+    // CSR adjacency over dense local indices, rebuilt after changes
+    bool graphDirty;
+    std::unordered_map<NodeId, uint32_t> localIndex;
+    std::vector<NodeId> localIds;
+    std::vector<Vector2> localPositions;
+    std::vector<uint32_t> edgeOffsets;  // Node i's roads are edges [offsets[i], offsets[i + 1])
+    std::vector<uint32_t> edgeTargets;
+    std::vector<float> edgeLengths;
+
+    // A* scratch, reused by every search
+    std::vector<float> lengthSoFar;
+    std::vector<uint32_t> parent;
+    std::vector<uint32_t> seenStamp;    // Search that last reached each node
+    std::vector<uint32_t> closedStamp;  // Search that last settled each node
+    uint32_t searchStamp;
+    std::vector<OpenEntry> open;        // Binary min-heap
+
+    std::unordered_map<uint64_t, Route> routes;  // RouteKey -> cached route
+    static constexpr size_t MAX_CACHED_ROUTES = 65536;  // Cleared whole when full
+};
+
+#endif // TRANSPORT_NETWORK_H
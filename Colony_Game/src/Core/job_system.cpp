@@ -0,0 +1,150 @@
+#include "job_system.h"
+
+// Index of the queue owned by this thread, 0 for threads that are not workers
+static thread_local size_t threadQueueIndex = 0;
+
+JobSystem& JobSystem::Global() {
+    static JobSystem jobSystem(GetDefaultWorkerCount());
+    return jobSystem;
+}
+
+size_t JobSystem::GetDefaultWorkerCount() {
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+JobSystem::JobSystem(size_t workerCount) : queuedJobs(0), running(false) {
+    StartWorkers(workerCount);
+}
+
+JobSystem::~JobSystem() {
+    StopWorkers();
+}
+
+void JobSystem::SetWorkerCount(size_t workerCount) {
+    StopWorkers();
+    StartWorkers(workerCount);
+}
+
+void JobSystem::StartWorkers(size_t workerCount) {
+    queues.clear();
+    for (size_t i = 0; i <= workerCount; i++) {
+        queues.emplace_back(new Queue());
+    }
+
+    running = true;
+    for (size_t i = 0; i < workerCount; i++) {
+        workers.emplace_back(&JobSystem::WorkerLoop, this, i + 1);
+    }
+}
+
+void JobSystem::StopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        running = false;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+size_t JobSystem::GetQueueIndex() const {
+    // A worker of a previous pool generation could still hold a larger index
+    return threadQueueIndex < queues.size() ? threadQueueIndex : 0;
+}
+
+void JobSystem::Submit(Task& task, size_t count, size_t grain) {
+    Queue& queue = *queues[GetQueueIndex()];
+    size_t chunks = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // Pushed in reverse so the owner, popping from the back, starts at index 0
+        // while thieves take the far end of the range
+        size_t begin = ((count - 1) / grain) * grain;
+        while (true) {
+            size_t end = begin + grain < count ? begin + grain : count;
+            queue.jobs.push_back(Job{&task, begin, end});
+            chunks++;
+            if (begin == 0) {
+                break;
+            }
+            begin -= grain;
+        }
+    }
+    queuedJobs.fetch_add(chunks, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_all();
+}
+
+void JobSystem::Wait(Task& task) {
+    size_t queueIndex = GetQueueIndex();
+    while (task.remaining.load(std::memory_order_acquire) > 0) {
+        // Help out instead of blocking; our own chunks are usually at the back of our queue
+        if (!RunOne(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::Pop(Queue& queue, Job& job, bool fromBack) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.front == queue.jobs.size()) {
+        return false;
+    }
+
+    if (fromBack) {
+        job = queue.jobs.back();
+        queue.jobs.pop_back();
+    } else {
+        job = queue.jobs[queue.front++];
+    }
+
+    if (queue.front == queue.jobs.size()) {
+        queue.jobs.clear();
+        queue.front = 0;
+    }
+    return true;
+}
+
+bool JobSystem::RunOne(size_t queueIndex) {
+    Job job;
+    bool found = Pop(*queues[queueIndex], job, true);
+
+    // Steal from the other queues, starting after our own so thieves spread out
+    for (size_t i = 1; !found && i < queues.size(); i++) {
+        found = Pop(*queues[(queueIndex + i) % queues.size()], job, false);
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    job.task->run(job.task->body, job.begin, job.end);
+    job.task->remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobSystem::WorkerLoop(size_t queueIndex) {
+    threadQueueIndex = queueIndex;
+
+    while (true) {
+        if (RunOne(queueIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]() {
+            return !running || queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+        if (!running) {
+            break;
+        }
+    }
+}
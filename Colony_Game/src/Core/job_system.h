@@ -0,0 +1,106 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool.
+//
+// ParallelFor splits a range into chunks and pushes them onto the calling
+// thread's queue. The caller works through its queue from the back while idle
+// workers steal from the front. A caller waiting for its chunks keeps running
+// jobs, so ParallelFor may be nested (colonies in parallel, sects of each
+// colony in parallel) without blocking a worker.
+//
+// Which thread runs a chunk is not deterministic. Bodies must only write
+// state that belongs to their own indices.
+class JobSystem {
+public:
+    static JobSystem& Global();
+
+    explicit JobSystem(size_t workerCount);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Stops the workers and starts workerCount new ones; only call while no jobs run.
+    // With zero workers everything runs on the calling thread.
+    void SetWorkerCount(size_t workerCount);
+    size_t GetWorkerCount() const { return workers.size(); }
+    static size_t GetDefaultWorkerCount();  // One per core besides the calling thread
+
+    // Runs body(begin, end) over [0, count) in chunks of at most grain indices
+    // and returns once every chunk has run
+    template<typename Body>
+    void ParallelFor(size_t count, size_t grain, const Body& body);
+
+private:
+    struct Task {
+        void (*run)(const void* body, size_t begin, size_t end);
+        const void* body;
+        std::atomic<size_t> remaining;  // Chunks not finished yet
+    };
+
+    struct Job {
+        Task* task;
+        size_t begin;
+        size_t end;
+    };
+
+    // The owner pushes and pops at the back, thieves take from the front.
+    // Stored in a vector that is only rewound once empty, so it stops
+    // allocating after the first ticks.
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Job> jobs;
+        size_t front = 0;
+    };
+
+    void Submit(Task& task, size_t count, size_t grain);
+    void Wait(Task& task);
+    bool RunOne(size_t queueIndex);
+    bool Pop(Queue& queue, Job& job, bool fromBack);
+    size_t GetQueueIndex() const;
+    void StartWorkers(size_t workerCount);
+    void StopWorkers();
+    void WorkerLoop(size_t queueIndex);
+
+    std::vector<std::unique_ptr<Queue>> queues;  // 0 is shared by all non-worker threads
+    std::vector<std::thread> workers;            // Worker i owns queue i + 1
+    std::atomic<size_t> queuedJobs;
+
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool running;
+};
+
+template<typename Body>
+void JobSystem::ParallelFor(size_t count, size_t grain, const Body& body) {
+    if (grain == 0) {
+        grain = 1;
+    }
+    if (workers.empty() || count <= grain) {
+        if (count > 0) {
+            body(size_t(0), count);
+        }
+        return;
+    }
+
+    Task task;
+    task.run = [](const void* fn, size_t begin, size_t end) {
+        (*static_cast<const Body*>(fn))(begin, end);
+    };
+    task.body = &body;
+    task.remaining.store((count + grain - 1) / grain, std::memory_order_relaxed);
+
+    Submit(task, count, grain);
+    Wait(task);
+}
+
+#endif // JOB_SYSTEM_H
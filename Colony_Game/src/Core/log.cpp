@@ -0,0 +1,123 @@
+#include "log.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+static const char* GetLevelPrefix(LogLevel level) {
+    switch (level) {
+        case LogLevel::Debug: return "[DEBUG] ";
+        case LogLevel::Info: return "[INFO] ";
+        case LogLevel::Warning: return "[WARNING] ";
+        case LogLevel::Error: return "[ERROR] ";
+    }
+    return "";
+}
+
+Logger& Logger::Global() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger() {
+    writer = std::thread(&Logger::WriterLoop, this);
+}
+
+Logger::~Logger() {
+    stopping.store(true);
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    Drain();
+}
+
+Logger::RingBuffer* Logger::GetThreadBuffer() {
+    // Buffers belong to the logger so they outlive their threads
+    thread_local RingBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        buffers.emplace_back(new RingBuffer());
+        buffer = buffers.back().get();
+    }
+    return buffer;
+}
+
+void Logger::Write(LogLevel level, const char* format, ...) {
+    RingBuffer* buffer = GetThreadBuffer();
+
+    size_t head = buffer->head.load(std::memory_order_relaxed);
+    if (head - buffer->tail.load(std::memory_order_acquire) >= BUFFER_RECORDS) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Record& record = buffer->records[head & (BUFFER_RECORDS - 1)];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(record.text, RECORD_SIZE, format, args);
+    va_end(args);
+
+    record.level = level;
+    record.length = static_cast<uint16_t>(length < 0 ? 0 : std::min<size_t>(length, RECORD_SIZE - 1));
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+bool Logger::Drain() {
+    bool wroteAny = false;
+    std::lock_guard<std::mutex> lock(buffersMutex);
+
+    for (auto& buffer : buffers) {
+        size_t tail = buffer->tail.load(std::memory_order_relaxed);
+        size_t head = buffer->head.load(std::memory_order_acquire);
+
+        for (; tail != head; tail++) {
+            const Record& record = buffer->records[tail & (BUFFER_RECORDS - 1)];
+            std::fputs(GetLevelPrefix(record.level), stdout);
+            std::fwrite(record.text, 1, record.length, stdout);
+            std::fputc('\n', stdout);
+            wroteAny = true;
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+
+    if (wroteAny) {
+        std::fflush(stdout);
+    }
+    return wroteAny;
+}
+
+void Logger::WriterLoop() {
+    while (true) {
+        if (Drain()) {
+            continue;
+        }
+        if (stopping.load()) {
+            break;
+        }
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_for(lock, std::chrono::milliseconds(5));
+    }
+}
+
+void Logger::Flush() {
+    while (true) {
+        bool pending = false;
+        {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            for (auto& buffer : buffers) {
+                if (buffer->tail.load(std::memory_order_acquire) != buffer->head.load(std::memory_order_acquire)) {
+                    pending = true;
+                    break;
+                }
+            }
+        }
+        if (!pending) {
+            return;
+        }
+        wake.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Log levels. Messages below COLONY_LOG_LEVEL are removed at compile time,
+// so LOG_DEBUG in a tick loop costs nothing in a normal build.
+#define COLONY_LOG_LEVEL_DEBUG 0
+#define COLONY_LOG_LEVEL_INFO 1
+#define COLONY_LOG_LEVEL_WARNING 2
+#define COLONY_LOG_LEVEL_ERROR 3
+
+#ifndef COLONY_LOG_LEVEL
+#define COLONY_LOG_LEVEL COLONY_LOG_LEVEL_INFO
+#endif
+
+enum class LogLevel : uint8_t {
+    Debug = COLONY_LOG_LEVEL_DEBUG,
+    Info = COLONY_LOG_LEVEL_INFO,
+    Warning = COLONY_LOG_LEVEL_WARNING,
+    Error = COLONY_LOG_LEVEL_ERROR
+};
+
+// Asynchronous logger.
+//
+// Each thread formats its messages into its own fixed-size ring buffer
+// (single producer, single consumer, no locks). A background thread drains
+// all buffers and writes them to stdout, so the calling thread never waits
+// on I/O. When a buffer is full the message is dropped and counted.
+class Logger {
+public:
+    static Logger& Global();
+
+    void Write(LogLevel level, const char* format, ...)
+#if defined(__GNUC__)
+        __attribute__((format(printf, 3, 4)))
+#endif
+        ;
+
+    // Blocks until everything logged so far has been written
+    void Flush();
+
+    size_t GetDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    ~Logger();
+
+private:
+    static constexpr size_t RECORD_SIZE = 240;     // Longest message, longer ones are truncated
+    static constexpr size_t BUFFER_RECORDS = 1024; // Per thread, must be a power of two
+
+    struct Record {
+        LogLevel level;
+        uint16_t length;
+        char text[RECORD_SIZE];
+    };
+
+    struct RingBuffer {
+        Record records[BUFFER_RECORDS];
+        std::atomic<size_t> head{0};  // Next record the owning thread writes
+        std::atomic<size_t> tail{0};  // Next record the writer thread reads
+    };
+
+    Logger();
+    RingBuffer* GetThreadBuffer();
+    bool Drain();
+    void WriterLoop();
+
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<RingBuffer>> buffers;
+    std::atomic<size_t> dropped{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    std::thread writer;
+};
+
+#define COLONY_LOG(level, ...) Logger::Global().Write(level, __VA_ARGS__)
+
+#if COLONY_LOG_LEVEL <= COLONY_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) COLONY_LOG(LogLevel::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
+
+#if COLONY_LOG_LEVEL <= COLONY_LOG_LEVEL_INFO
+#define LOG_INFO(...) COLONY_LOG(LogLevel::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#endif
+
+#if COLONY_LOG_LEVEL <= COLONY_LOG_LEVEL_WARNING
+#define LOG_WARNING(...) COLONY_LOG(LogLevel::Warning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void)0)
+#endif
+
+#define LOG_ERROR(...) COLONY_LOG(LogLevel::Error, __VA_ARGS__)
+
+#endif // LOG_H
@@ -0,0 +1,85 @@
+#ifndef LRU_LIST_H
+#define LRU_LIST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Recency order over the ids [0, idCount), as an intrusive doubly linked list
+// kept in arrays. Touching, removing and finding the coldest id are O(1) and
+// never allocate after Reset.
+class LruList {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    LruList() : head(NONE), tail(NONE), size(0) {}
+
+    // Empties the list and sizes it for idCount ids
+    void Reset(size_t idCount) {
+        previous.assign(idCount, NONE);
+        next.assign(idCount, NONE);
+        linked.assign(idCount, 0);
+        head = tail = NONE;
+        size = 0;
+    }
+
+    bool Contains(uint32_t id) const { return linked[id] != 0; }
+    size_t Size() const { return size; }
+    bool Empty() const { return size == 0; }
+
+    // Makes id the most recent, adding it if absent
+    void Touch(uint32_t id) {
+        if (linked[id]) {
+            if (head == id) {
+                return;
+            }
+            Unlink(id);
+        }
+        previous[id] = NONE;
+        next[id] = head;
+        if (head != NONE) {
+            previous[head] = id;
+        }
+        head = id;
+        if (tail == NONE) {
+            tail = id;
+        }
+        linked[id] = 1;
+        size++;
+    }
+
+    void Remove(uint32_t id) {
+        if (linked[id]) {
+            Unlink(id);
+        }
+    }
+
+    uint32_t GetLeastRecent() const { return tail; }  // NONE when empty
+    uint32_t GetMostRecent() const { return head; }
+    uint32_t GetNext(uint32_t id) const { return next[id]; }  // Towards older ids
+
+private:
+    void Unlink(uint32_t id) {
+        if (previous[id] != NONE) {
+            next[previous[id]] = next[id];
+        } else {
+            head = next[id];
+        }
+        if (next[id] != NONE) {
+            previous[next[id]] = previous[id];
+        } else {
+            tail = previous[id];
+        }
+        linked[id] = 0;
+        size--;
+    }
+
+    std::vector<uint32_t> previous;
+    std::vector<uint32_t> next;
+    std::vector<uint8_t> linked;
+    uint32_t head;  // Most recent
+    uint32_t tail;  // Least recent
+    size_t size;
+};
+
+#endif // LRU_LIST_H
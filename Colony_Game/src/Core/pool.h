@@ -0,0 +1,186 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Slab allocator for game objects.
+//
+// Objects live in blocks of contiguous slots and never move, so pointers
+// and handles stay valid until the object is destroyed. A handle carries a
+// generation counter: Get() returns nullptr for a handle whose object was
+// destroyed, even if the slot has been reused since. Reserve() allocates
+// one block for a whole batch. Memory goes back block by block, but Clear()
+// and the destructor still run ~T once per live object; only trivially
+// destructible objects are dropped with their blocks without a visit, and
+// Discard() drops any objects that way once their owner has undone in bulk
+// whatever their destructors would have.
+template <typename T>
+class Pool {
+public:
+    struct Handle {
+        uint32_t block = INVALID_INDEX;
+        uint32_t slot = 0;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return block != INVALID_INDEX; }
+        bool operator==(const Handle& other) const {
+            return block == other.block && slot == other.slot && generation == other.generation;
+        }
+    };
+
+    explicit Pool(size_t blockSize = 256) : blockSize(blockSize), liveCount(0) {}
+    ~Pool() {
+        if (!std::is_trivially_destructible<T>::value) {
+            Clear();
+        }
+        for (auto& block : blocks) {
+            ::operator delete(block.slots);
+        }
+    }
+
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    // Makes room for count more objects with at most one allocation
+    void Reserve(size_t count) {
+        if (freeSlots.size() < count) {
+            AllocateBlock(count - freeSlots.size());
+        }
+    }
+
+    template <typename... Args>
+    Handle Create(Args&&... args) {
+        if (freeSlots.empty()) {
+            AllocateBlock(blockSize);
+        }
+        Handle handle = freeSlots.back();
+        freeSlots.pop_back();
+
+        Slot& slot = blocks[handle.block].slots[handle.slot];
+        new (slot.storage) T(std::forward<Args>(args)...);
+        slot.alive = true;
+        handle.generation = slot.generation;
+        liveCount++;
+        return handle;
+    }
+
+    void Destroy(Handle handle) {
+        Slot* slot = Find(handle);
+        if (!slot) {
+            return;
+        }
+        Release(*slot, handle.block, handle.slot);
+    }
+
+    // Returns nullptr if the handle is stale or invalid
+    T* Get(Handle handle) const {
+        Slot* slot = Find(handle);
+        return slot ? slot->Object() : nullptr;
+    }
+
+    // Visits live objects in memory order
+    template <typename Fn>
+    void ForEach(Fn fn) {
+        for (auto& block : blocks) {
+            for (size_t i = 0; i < block.count; i++) {
+                if (block.slots[i].alive) {
+                    fn(*block.slots[i].Object());
+                }
+            }
+        }
+    }
+
+    // Destroys every live object, one ~T call each; blocks are kept for reuse
+    void Clear() {
+        for (uint32_t b = 0; b < blocks.size(); b++) {
+            for (uint32_t i = 0; i < blocks[b].count; i++) {
+                if (blocks[b].slots[i].alive) {
+                    Release(blocks[b].slots[i], b, i);
+                }
+            }
+        }
+    }
+
+    // Frees every block without running ~T. Handles and pointers into the
+    // pool must not be used again.
+    void Discard() {
+        for (auto& block : blocks) {
+            ::operator delete(block.slots);
+        }
+        blocks.clear();
+        freeSlots.clear();
+        liveCount = 0;
+    }
+
+    size_t Size() const { return liveCount; }
+    size_t Capacity() const { return liveCount + freeSlots.size(); }
+
+private:
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFFu;
+
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation;
+        bool alive;
+
+        T* Object() { return reinterpret_cast<T*>(storage); }
+    };
+
+    struct Block {
+        Slot* slots;
+        uint32_t count;
+    };
+
+    void AllocateBlock(size_t count) {
+        Block block;
+        block.slots = static_cast<Slot*>(::operator new(count * sizeof(Slot)));
+        block.count = static_cast<uint32_t>(count);
+        for (size_t i = 0; i < count; i++) {
+            block.slots[i].generation = 0;
+            block.slots[i].alive = false;
+        }
+
+        uint32_t blockIndex = static_cast<uint32_t>(blocks.size());
+        blocks.push_back(block);
+
+        // Push in reverse so slots are handed out in memory order
+        for (size_t i = count; i-- > 0;) {
+            Handle handle;
+            handle.block = blockIndex;
+            handle.slot = static_cast<uint32_t>(i);
+            freeSlots.push_back(handle);
+        }
+    }
+
+    Slot* Find(Handle handle) const {
+        if (handle.block >= blocks.size() || handle.slot >= blocks[handle.block].count) {
+            return nullptr;
+        }
+        Slot& slot = blocks[handle.block].slots[handle.slot];
+        return (slot.alive && slot.generation == handle.generation) ? &slot : nullptr;
+    }
+
+    void Release(Slot& slot, uint32_t block, uint32_t index) {
+        slot.Object()->~T();
+        slot.alive = false;
+        slot.generation++;
+        liveCount--;
+
+        Handle handle;
+        handle.block = block;
+        handle.slot = index;
+        freeSlots.push_back(handle);
+    }
+
+    size_t blockSize;
+    size_t liveCount;
+    std::vector<Block> blocks;
+    std::vector<Handle> freeSlots;
+};
+
+#endif // POOL_H
@@ -0,0 +1,166 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+Profiler& Profiler::Global() {
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::Now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+Profiler::Profiler() : enabled(true), capturing(false), captureStart(0), frameIndex(0) {}
+
+Profiler::ThreadData* Profiler::GetThreadData() {
+    // Thread data belongs to the profiler so it outlives its thread
+    thread_local ThreadData* data = nullptr;
+    if (!data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.emplace_back(new ThreadData());
+        data = threads.back().get();
+        data->threadId = static_cast<uint32_t>(threads.size());
+    }
+    return data;
+}
+
+void Profiler::Record(const char* name, uint64_t start, uint64_t end) {
+    ThreadData* data = GetThreadData();
+    std::lock_guard<std::mutex> lock(data->mutex);
+
+    // Few distinct names per thread, a linear scan beats hashing
+    bool found = false;
+    for (auto& total : data->frameTotals) {
+        if (total.first == name) {
+            total.second += end - start;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        data->frameTotals.push_back(std::make_pair(name, end - start));
+    }
+
+    if (capturing && data->events.size() < MAX_EVENTS_PER_THREAD) {
+        data->events.push_back(TraceEvent{name, start, end});
+    }
+}
+
+size_t Profiler::FindPhase(const char* name) {
+    // Few distinct names, a linear scan by pointer beats hashing the text
+    for (const auto& entry : phaseIndex) {
+        if (entry.first == name) {
+            return entry.second;
+        }
+    }
+
+    // A pointer seen for the first time, which may spell a name already known
+    size_t phase = 0;
+    while (phase < phases.size() && std::strcmp(phases[phase].name, name) != 0) {
+        phase++;
+    }
+    if (phase == phases.size()) {
+        phases.emplace_back();
+        phases.back().name = name;
+    }
+    phaseIndex.push_back(std::make_pair(name, phase));
+    return phase;
+}
+
+void Profiler::EndFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Gather this frame's totals by phase across all threads. Nothing here
+    // allocates once every phase has been seen.
+    for (auto& thread : threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        for (const auto& total : thread->frameTotals) {
+            phases[FindPhase(total.first)].frameTotal += total.second;
+        }
+        thread->frameTotals.clear();
+    }
+
+    size_t slot = frameIndex % FRAME_HISTORY;
+    for (auto& phase : phases) {
+        phase.frames[slot] = phase.frameTotal / 1.0e6f;
+        phase.frameTotal = 0;
+        phase.count = std::min(phase.count + 1, FRAME_HISTORY);
+    }
+    frameIndex++;
+}
+
+std::vector<Profiler::PhaseStats> Profiler::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<PhaseStats> stats;
+
+    for (const auto& phase : phases) {
+        size_t count = phase.count;
+        if (count == 0) {
+            continue;
+        }
+
+        // Most recent frames are not necessarily at the front, but order does not matter here
+        std::vector<float> frames(phase.frames, phase.frames + count);
+        std::sort(frames.begin(), frames.end());
+
+        PhaseStats entry;
+        entry.name = phase.name;
+        entry.p50 = frames[(count - 1) * 50 / 100];
+        entry.p95 = frames[(count - 1) * 95 / 100];
+        entry.p99 = frames[(count - 1) * 99 / 100];
+        entry.max = frames.back();
+        stats.push_back(entry);
+    }
+
+    // Listed by name, whatever order the phases first appeared in
+    std::sort(stats.begin(), stats.end(), [](const PhaseStats& a, const PhaseStats& b) { return a.name < b.name; });
+    return stats;
+}
+
+void Profiler::BeginCapture() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& thread : threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        thread->events.clear();
+    }
+    captureStart = Now();
+    capturing = true;
+}
+
+bool Profiler::EndCapture(const char* path) {
+    capturing = false;
+
+    std::FILE* file = std::fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::fputs("{\"traceEvents\":[\n", file);
+    bool first = true;
+    for (auto& thread : threads) {
+        std::lock_guard<std::mutex> threadLock(thread->mutex);
+        for (const auto& event : thread->events) {
+            if (event.start < captureStart) {
+                continue;
+            }
+            // Complete events, timestamps in microseconds
+            std::fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                         first ? "" : ",\n",
+                         event.name,
+                         thread->threadId,
+                         (event.start - captureStart) / 1000.0,
+                         (event.end - event.start) / 1000.0);
+            first = false;
+        }
+        thread->events.clear();
+    }
+    std::fputs("\n]}\n", file);
+
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,117 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstddef>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Hot-path timers.
+//
+// PROFILE_SCOPE("Name") times the rest of the enclosing block. Every thread
+// sums its timings per name into its own buffer; EndFrame() folds those
+// sums into a rolling history of frame totals per name, from which the
+// overlay reads percentiles. While a capture is running every scope is
+// also recorded as a Chrome trace event (load the file in chrome://tracing
+// or Perfetto).
+//
+// Building with -DCOLONY_PROFILE=0 removes all scopes.
+#ifndef COLONY_PROFILE
+#define COLONY_PROFILE 1
+#endif
+
+class Profiler {
+public:
+    static constexpr size_t FRAME_HISTORY = 240;  // Frames kept for percentiles
+
+    struct PhaseStats {
+        std::string name;
+        float p50;  // Milliseconds per frame
+        float p95;
+        float p99;
+        float max;
+    };
+
+    static Profiler& Global();
+    static uint64_t Now();  // Nanoseconds, monotonic
+
+    void SetEnabled(bool enabled) { this->enabled = enabled; }
+    bool IsEnabled() const { return enabled; }
+
+    void Record(const char* name, uint64_t start, uint64_t end);
+    void EndFrame();
+    std::vector<PhaseStats> GetStats() const;
+
+    // Chrome trace-event capture
+    void BeginCapture();
+    bool EndCapture(const char* path);  // Writes the JSON file, false on I/O error
+    bool IsCapturing() const { return capturing; }
+
+private:
+    static constexpr size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+
+    struct TraceEvent {
+        const char* name;
+        uint64_t start;
+        uint64_t end;
+    };
+
+    struct ThreadData {
+        std::mutex mutex;  // Only contended while EndFrame or EndCapture read it
+        uint32_t threadId;
+        std::vector<std::pair<const char*, uint64_t>> frameTotals;
+        std::vector<TraceEvent> events;
+    };
+
+    struct PhaseHistory {
+        const char* name = nullptr;
+        uint64_t frameTotal = 0;           // Nanoseconds gathered for the frame being ended
+        float frames[FRAME_HISTORY] = {};  // Milliseconds, ring buffer
+        size_t count = 0;                  // Frames recorded so far
+    };
+
+    Profiler();
+    ThreadData* GetThreadData();
+    size_t FindPhase(const char* name);  // Starts a history for a new name
+
+    std::atomic<bool> enabled;
+    std::atomic<bool> capturing;
+    uint64_t captureStart;
+
+    mutable std::mutex mutex;  // Guards threads and phases
+    std::vector<std::unique_ptr<ThreadData>> threads;
+    std::vector<PhaseHistory> phases;  // In order of first appearance
+    // Scope name pointers seen so far and their phase. Equal names from
+    // different translation units may be distinct pointers to one phase.
+    std::vector<std::pair<const char*, size_t>> phaseIndex;
+    size_t frameIndex;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : name(name), start(Profiler::Global().IsEnabled() ? Profiler::Now() : 0) {}
+    ~ProfileScope() {
+        if (start) {
+            Profiler::Global().Record(name, start, Profiler::Now());
+        }
+    }
+
+private:
+    const char* name;
+    uint64_t start;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if COLONY_PROFILE
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
+
+#endif // PROFILER_H
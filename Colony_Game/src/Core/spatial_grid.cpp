@@ -0,0 +1,104 @@
+#include "spatial_grid.h"
+
+SpatialGrid::SpatialGrid(float cellSize)
+    : cellSize(cellSize),
+      inverseCellSize(1.0f / cellSize),
+      size(0)
+{
+}
+
+void SpatialGrid::Clear() {
+    // Buckets are emptied in place, so refilling the same cells does not allocate.
+    // Those still empty since the previous Clear are dropped, so stale cells do not pile up.
+    for (auto it = cells.begin(); it != cells.end();) {
+        if (it->second.empty()) {
+            it = cells.erase(it);
+        } else {
+            it->second.clear();
+            ++it;
+        }
+    }
+    size = 0;
+}
+
+void SpatialGrid::Insert(uint32_t id, Vector2 position) {
+    cells[CellKey(position)].push_back(Entry{id, position});
+    size++;
+}
+
+void SpatialGrid::Remove(uint32_t id, Vector2 position) {
+    auto it = cells.find(CellKey(position));
+    if (it == cells.end()) {
+        return;
+    }
+
+    std::vector<Entry>& bucket = it->second;
+    for (size_t i = 0; i < bucket.size(); i++) {
+        if (bucket[i].id == id) {
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            size--;
+            break;
+        }
+    }
+
+    if (bucket.empty()) {
+        cells.erase(it);
+    }
+}
+
+void SpatialGrid::Move(uint32_t id, Vector2 from, Vector2 to) {
+    uint64_t fromKey = CellKey(from);
+    if (fromKey != CellKey(to)) {
+        Remove(id, from);
+        Insert(id, to);
+        return;
+    }
+
+    // Same cell: update in place
+    auto it = cells.find(fromKey);
+    if (it == cells.end()) {
+        return;
+    }
+    for (auto& entry : it->second) {
+        if (entry.id == id) {
+            entry.position = to;
+            break;
+        }
+    }
+}
+
+void SpatialGrid::Rename(uint32_t id, uint32_t newId, Vector2 position) {
+    auto it = cells.find(CellKey(position));
+    if (it == cells.end()) {
+        return;
+    }
+    for (auto& entry : it->second) {
+        if (entry.id == id) {
+            entry.id = newId;
+            break;
+        }
+    }
+}
+
+void SpatialGrid::QueryRadius(Vector2 center, float radius, std::vector<uint32_t>& ids) const {
+    ForEachInRadius(center, radius, [&ids](const Entry& entry) {
+        ids.push_back(entry.id);
+    });
+}
+
+bool SpatialGrid::FindNearest(Vector2 center, float radius, uint32_t& id) const {
+    bool found = false;
+    float best = radius * radius;
+    ForEachInRadius(center, radius, [&](const Entry& entry) {
+        float dx = entry.position.x - center.x;
+        float dy = entry.position.y - center.y;
+        float distanceSquared = dx * dx + dy * dy;
+        if (!found || distanceSquared < best) {
+            best = distanceSquared;
+            id = entry.id;
+            found = true;
+        }
+    });
+    return found;
+}
@@ -0,0 +1,114 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "raylib.h"
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Uniform grid over points in world space, for picking and range queries.
+//
+// Points are bucketed by cell in a hash map, so the grid needs no bounds and
+// empty space costs nothing. A query visits only the cells its circle or
+// rectangle overlaps, which makes it independent of how many points lie
+// elsewhere. Ids are chosen by the owner, typically an index into its own
+// array.
+class SpatialGrid {
+public:
+    struct Entry {
+        uint32_t id;
+        Vector2 position;
+    };
+
+    explicit SpatialGrid(float cellSize = 200.0f);
+
+    void Clear();  // Keeps the buckets of cells that held points, for refilling
+    void Insert(uint32_t id, Vector2 position);
+    void Remove(uint32_t id, Vector2 position);
+    void Move(uint32_t id, Vector2 from, Vector2 to);
+    void Rename(uint32_t id, uint32_t newId, Vector2 position);  // For owners that swap-remove
+
+    size_t Size() const { return size; }
+    float GetCellSize() const { return cellSize; }
+
+    // Calls fn(const Entry&) for every point within radius of center
+    template<typename Fn>
+    void ForEachInRadius(Vector2 center, float radius, Fn&& fn) const;
+
+    // Calls fn(const Entry&) for every point inside the rectangle
+    template<typename Fn>
+    void ForEachInRect(Vector2 min, Vector2 max, Fn&& fn) const;
+
+    void QueryRadius(Vector2 center, float radius, std::vector<uint32_t>& ids) const;
+    bool FindNearest(Vector2 center, float radius, uint32_t& id) const;  // False if none within radius
+
+private:
+    int CellCoordinate(float value) const { return static_cast<int>(std::floor(value * inverseCellSize)); }
+    static uint64_t CellKey(int x, int y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+    uint64_t CellKey(Vector2 position) const {
+        return CellKey(CellCoordinate(position.x), CellCoordinate(position.y));
+    }
+
+    float cellSize;
+    float inverseCellSize;
+    size_t size;
+    std::unordered_map<uint64_t, std::vector<Entry>> cells;
+};
+
+template<typename Fn>
+void SpatialGrid::ForEachInRadius(Vector2 center, float radius, Fn&& fn) const {
+    float radiusSquared = radius * radius;
+    ForEachInRect({center.x - radius, center.y - radius}, {center.x + radius, center.y + radius},
+                  [&](const Entry& entry) {
+        float dx = entry.position.x - center.x;
+        float dy = entry.position.y - center.y;
+        if (dx * dx + dy * dy <= radiusSquared) {
+            fn(entry);
+        }
+    });
+}
+
+template<typename Fn>
+void SpatialGrid::ForEachInRect(Vector2 min, Vector2 max, Fn&& fn) const {
+    if (size == 0) {
+        return;
+    }
+
+    int minX = CellCoordinate(min.x);
+    int minY = CellCoordinate(min.y);
+    int maxX = CellCoordinate(max.x);
+    int maxY = CellCoordinate(max.y);
+
+    // A rectangle covering more cells than are occupied is cheaper to answer by walking the occupied ones
+    if (static_cast<double>(maxX - minX + 1) * (maxY - minY + 1) > static_cast<double>(cells.size())) {
+        for (const auto& cell : cells) {
+            for (const auto& entry : cell.second) {
+                if (entry.position.x >= min.x && entry.position.x <= max.x &&
+                    entry.position.y >= min.y && entry.position.y <= max.y) {
+                    fn(entry);
+                }
+            }
+        }
+        return;
+    }
+
+    for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+            auto it = cells.find(CellKey(x, y));
+            if (it == cells.end()) {
+                continue;
+            }
+            for (const auto& entry : it->second) {
+                if (entry.position.x >= min.x && entry.position.x <= max.x &&
+                    entry.position.y >= min.y && entry.position.y <= max.y) {
+                    fn(entry);
+                }
+            }
+        }
+    }
+}
+
+#endif // SPATIAL_GRID_H
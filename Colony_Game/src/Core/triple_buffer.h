@@ -0,0 +1,46 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free triple buffer for one writer thread and one reader thread.
+//
+// The writer fills the back slot and publishes it; the reader takes the newest
+// published slot. Each side owns one slot and the third is swapped through a
+// single atomic, so neither side ever waits and a slot is never written while
+// it is being read. Slots are reused, so containers inside T keep their
+// capacity and publishing stops allocating after a few rounds.
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : back(0), middle(1), front(2) {}
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // Writer side
+    T& GetBack() { return slots[back]; }
+    void Publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side: the newest published value, unchanged until the next call
+    const T& GetFront() {
+        if (middle.load(std::memory_order_relaxed) & FRESH) {
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return slots[front];
+    }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH = 4;  // Set while the middle slot has not been read
+
+    T slots[3];
+    uint8_t back;                  // Owned by the writer
+    std::atomic<uint8_t> middle;   // Index of the shared slot, plus FRESH
+    uint8_t front;                 // Owned by the reader
+};
+
+#endif // TRIPLE_BUFFER_H
@@ -1,54 +1,83 @@
 #include "Engine.h"
 
 #include <iostream>
+#include "log.h"
+#include "profiler.h"
+#include "job_system.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+double Engine::SimClock() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-Engine::Engine(int screenWidth, int screenHeight, const char* title)
+Engine::Engine(int screenWidth, int screenHeight, const char* title, bool headless)
     : screenWidth(screenWidth),
       screenHeight(screenHeight),
+      headless(headless),
+      title(title),
       currentView(View::Menu),
       planet(new Planet()),
+      gridLayer(nullptr),
       currentColony(nullptr),
       currentSect(nullptr),
       currentUnit(nullptr),
+      hoveredColony(-1),
+      hoveredSect(-1),
       lastClickTime(0),
       lastClickPosition({0, 0}),
       minZoom(0.5f),
       maxZoom(2.0f),
-      isDragging(false)
+      isDragging(false),
+      sectDetail(SectDetail::Full),
+      simRunning(false),
+      timeScale(1.0f),
+      focusedSect(nullptr),
+      streamView({0, 0, 0, 0}),
+      view(nullptr),
+      simAlpha(0.0f),
+      simTick(0),
+      simAccumulator(0.0),
+      simTicksThisSecond(0),
+      simRateWindowStart(0.0),
+      simTicksPerSecond(0.0f),
+      showProfiler(false)
 {
-    InitWindow(screenWidth, screenHeight, title);
-    SetTargetFPS(60);
-
     // Initialize camera
     camera.target = {0, 0};
     camera.offset = {static_cast<float>(screenWidth)/2, static_cast<float>(screenHeight)/2};
     camera.rotation = 0.0f;
     camera.zoom = 1.0f;
+
+    view = &snapshots.GetFront();  // Empty until the simulation starts
 }
 
 Engine::~Engine() {
-    delete planet;  // Clean up in destructor
+    StopSimulation();
 
-    CloseWindow();
+    for (auto colony : colonies) {
+        delete colony;
+    }
+    delete planet;  // Clean up in destructor
 }
 
 void Engine::InitGame() {
+    if (!planet->IsMapGenerated()) {
+        planet->GenerateMap();
+    }
+
     // Create initial colony
-    Colony* firstColony = new Colony();
+    Colony* firstColony = new Colony(planet->GetConfig().GetSectRadius());
     colonies.push_back(firstColony);
     currentColony = firstColony;
 
     // Create initial sect with a position near the center of the map
-    Sect* firstSect = new Sect();
     Vector2 initialPosition = {
         static_cast<float>(screenWidth) / 2.0f,
         static_cast<float>(screenHeight) / 2.0f
     };
-    firstSect->SetPosition(initialPosition);
-
-    // Add sect to colony
-    currentColony->AddSect(firstSect);
-    currentSect = firstSect;
+    currentSect = currentColony->AddSect(initialPosition);
 
     UpdatePlanetActiveArea();
 
@@ -62,417 +91,328 @@ void Engine::InitGame() {
     currentView = View::Menu;
 }
 
-void Engine::Run() {
-    while (!WindowShouldClose()) {
-        HandleInput();
-        Update();
-        Draw();
+void Engine::PopulateWorld(int colonyCount, int sectsPerColony) {
+    // Lay colonies out as square blocks of grid cells, one sect per cell
+    int colonySide = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(sectsPerColony))));
+    int coloniesPerRow = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(colonyCount))));
+
+    // Grow the planet until the blocks fit on it. Past its largest size the
+    // layout would run off the grid, so nothing is built.
+    PlanetConfig config = planet->GetConfig();
+    int needed = coloniesPerRow * (colonySide + 1);
+    if (needed > PlanetConfig::MAX_CELLS) {
+        LOG_WARNING("%d colonies of %d sects need %dx%d cells, the planet has at most %dx%d; world not populated.",
+                    colonyCount, sectsPerColony, needed, needed, PlanetConfig::MAX_CELLS, PlanetConfig::MAX_CELLS);
+        return;
     }
-}
-
-bool Engine::IsDoubleClick() {
-    double currentTime = GetTime();
-    Vector2 currentPosition = GetMousePosition();
-
-    bool isDoubleClick = (currentTime - lastClickTime <= 0.5) &&
-                         (Vector2Distance(lastClickPosition, currentPosition) <= 10);
+    if (needed > config.width || needed > config.height) {
+        config.width = std::max(config.width, needed);
+        config.height = std::max(config.height, needed);
+        ConfigurePlanet(config);
+    }
+    float cellSize = planet->GetConfig().cellSize;
 
-    lastClickTime = currentTime;
-    lastClickPosition = currentPosition;
+    for (int c = 0; c < colonyCount; c++) {
+        Colony* colony = new Colony(planet->GetConfig().GetSectRadius());
+        colony->ReserveSects(sectsPerColony);
+        colonies.push_back(colony);
 
-    return isDoubleClick;
-}
+        int originX = (c % coloniesPerRow) * (colonySide + 1);
+        int originY = (c / coloniesPerRow) * (colonySide + 1);
 
+        for (int s = 0; s < sectsPerColony; s++) {
+            colony->AddSect({
+                (originX + s % colonySide + 0.5f) * cellSize,
+                (originY + s / colonySide + 0.5f) * cellSize
+            });
+        }
 
-void Engine::SwitchToColonyView() {
-    if (currentColony) {
-        currentView = View::Colony;
+        // A road along each row, and every sect but the last in a row ships iron
+        // to its neighbour down the road. Roads first, so the graph is built once.
+        const std::vector<Sect*>& sects = colony->GetSects();
+        for (int s = 0; s + 1 < sectsPerColony; s++) {
+            if ((s + 1) % colonySide != 0) {
+                colony->BuildRoad(sects[s], sects[s + 1]);
+            }
+        }
+        for (int s = 0; s + 1 < sectsPerColony; s++) {
+            if ((s + 1) % colonySide != 0) {
+                colony->AddShipment(sects[s], sects[s + 1], Resource::Iron, SHIPMENT_AMOUNT);
+            }
+        }
     }
-}
 
-void Engine::SwitchToSectView() {
-    if (currentColony && currentSect) {
-        currentView = View::Sect;
+    if (!currentColony && !colonies.empty()) {
+        currentColony = colonies.front();
     }
+    UpdatePlanetActiveArea();
 }
 
-void Engine::SwitchToUnitView() {
-    if (currentColony && currentSect && currentUnit) {
-        currentView = View::Unit;
+void Engine::RunHeadless(long ticks, const char* tracePath) {
+    if (tracePath) {
+        Profiler::Global().BeginCapture();
     }
-}
-
-void Engine::SwitchToPlanetView() {
-    currentView = View::Planet;
-    UpdatePlanetActiveArea();  // Make sure active area is updated when switching views
-    ResetCameraForCurrentView();
-}
 
-void Engine::SelectColony(Vector2 mousePosition) {
-    // Logic to determine which colony was clicked
-    Vector2 worldMousePos = GetScreenToWorld2D(mousePosition, camera);
+    auto start = std::chrono::steady_clock::now();
 
-    for (auto& colony : colonies) {
-        if (Vector2Distance(worldMousePos, colony->GetCentroid()) <= colony->GetRadius()) {
-            currentColony = colony;
-            SwitchToColonyView();
-            break;
-        }
+    for (long i = 0; i < ticks; i++) {
+        Tick();
+        Profiler::Global().EndFrame();
     }
-}
 
-void Engine::SelectSect(Vector2 mousePosition) {
-    // Logic to determine which sect was clicked
-    if (currentColony) {
-        // Convert screen coordinates to world coordinates using the camera
-        Vector2 worldMousePos = GetScreenToWorld2D(mousePosition, camera);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
 
-        for (auto& sect : currentColony->GetSects()) {
-            Vector2 sectPos = sect->GetPosition();
-            float sectRadius = sect->GetRadius();
+    // Let queued log lines out first so the report comes last
+    Logger::Global().Flush();
 
-            if (Vector2Distance(worldMousePos, sectPos) <= sectRadius) {
-                currentSect = sect;
-                SwitchToSectView();
-                break;
-            }
-        }
+    std::cout << "Headless run: " << ticks << " ticks, "
+              << colonies.size() << " colonies, "
+              << GetSectCount() << " sects in "
+              << seconds << " s";
+    if (seconds > 0) {
+        std::cout << " (" << ticks / seconds << " ticks/s)";
     }
-}
-
+    std::cout << std::endl;
 
-void Engine::SelectUnit(Vector2 mousePosition) {
-    // Logic to determine which unit was clicked
-    if (currentSect) {
-        for (auto& unit : currentSect->GetUnits()) {
-            if (Vector2Distance(mousePosition, unit->GetUnitPosInSectView()) <= unit->GetUnitRadiusInSectView()) {
-                currentUnit = unit;
-                SwitchToUnitView();
-                break;
-            }
-        }
+    if (Logger::Global().GetDroppedCount() > 0) {
+        std::cout << Logger::Global().GetDroppedCount() << " log messages dropped" << std::endl;
     }
-}
 
-void Engine::HandleInput() {
-
-    HandleCameraControls();  // Always handle camera controls first
-
-    switch (currentView) {
-        case View::Menu:
-            if (IsKeyPressed(KEY_ENTER)) {
-                SwitchToColonyView();
-            }
-            break;
-        case View::Planet:
-            if (IsKeyPressed(KEY_C)) {
-                SwitchToColonyView();
-            }
-            break;
-        case View::Colony:
-            if (IsKeyPressed(KEY_S)) {
-                SwitchToSectView();
-            }
-            if (IsKeyPressed(KEY_P)) {
-                SwitchToPlanetView();
-            }
-            break;
-        case View::Sect:
-            if (IsKeyPressed(KEY_U)) {
-                SwitchToUnitView();
-            }
-            if (IsKeyPressed(KEY_C)) {
-                SwitchToColonyView();
-            }
-            break;
-        case View::Unit:
-            if (IsKeyPressed(KEY_S)) {
-                SwitchToSectView();
-            }
-            break;
+    // Per-phase cost over the last ticks
+    for (const auto& phase : Profiler::Global().GetStats()) {
+        std::cout << "  " << phase.name << ": p50 " << phase.p50
+                  << " ms, p95 " << phase.p95
+                  << " ms, p99 " << phase.p99
+                  << " ms, max " << phase.max << " ms" << std::endl;
     }
 
-    // Handle double-click selection of specific colonies, sects, and units
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && IsDoubleClick()) {
-        Vector2 mousePosition = GetMousePosition();
-        switch (currentView) {
-            case View::Planet:
-                SelectColony(mousePosition);
-                break;
-            case View::Colony:
-                SelectSect(mousePosition);
-                break;
-            case View::Sect:
-                SelectUnit(mousePosition);
-                break;
-            case View::Unit:
-                // Handle double-click in Unit view if needed
-                break;
-            case View::Menu:
-                // Handle double-click in Menu if needed
-                break;
+    if (tracePath) {
+        if (Profiler::Global().EndCapture(tracePath)) {
+            std::cout << "Trace written to " << tracePath << std::endl;
+        } else {
+            std::cout << "Could not write trace to " << tracePath << std::endl;
         }
     }
 }
 
-void Engine::ClampCamera() {
-    // Calculate visible area in world coordinates
-    float visibleWidth = screenWidth / camera.zoom;
-    float visibleHeight = screenHeight / camera.zoom;
-
-    // Calculate bounds considering visible area
-    float minX = visibleWidth / 2;
-    float minY = visibleHeight / 2;
-    float maxX = PLANET_WIDTH - (visibleWidth / 2);
-    float maxY = PLANET_HEIGHT - (visibleHeight / 2);
-
-    // Adjust bounds when zoomed out
-    if (visibleWidth >= PLANET_WIDTH) {
-        camera.target.x = PLANET_WIDTH / 2;
-    } else {
-        camera.target.x = Clamp(camera.target.x, minX, maxX);
-    }
-
-    if (visibleHeight >= PLANET_HEIGHT) {
-        camera.target.y = PLANET_HEIGHT / 2;
-    } else {
-        camera.target.y = Clamp(camera.target.y, minY, maxY);
+void Engine::ConfigurePlanet(const PlanetConfig& config) {
+    if (simRunning) {
+        LOG_WARNING("Engine::ConfigurePlanet ignored while the simulation runs.");
+        return;
     }
+    planet->Configure(config);
+    planet->GenerateMap();
+    UpdatePlanetActiveArea();
 }
 
-void Engine::HandleCameraControls() {
-    // Mouse wheel zooming
-    float wheel = GetMouseWheelMove();
-    if (wheel != 0) {
-        // Get world point before zoom
-        Vector2 mouseWorldPos = GetScreenToWorld2D(GetMousePosition(), camera);
-
-        // Modify zoom
-        float prevZoom = camera.zoom;
-        camera.zoom += wheel * 0.1f;
-
-        // Calculate max zoom out to see whole planet
-        float maxZoomOut = std::min(
-            screenWidth / PLANET_WIDTH,
-            screenHeight / PLANET_HEIGHT
-        );
-
-        // Clamp zoom between max zoom out and maxZoom
-        camera.zoom = Clamp(camera.zoom, maxZoomOut, maxZoom);
-
-        // Get world point after zoom
-        Vector2 mouseWorldPosNew = GetScreenToWorld2D(GetMousePosition(), camera);
-
-        // Only adjust position if zoom actually changed
-        if (camera.zoom != prevZoom) {
-            // Get world point after zoom
-            Vector2 mouseWorldPosNew = GetScreenToWorld2D(GetMousePosition(), camera);
-
-            // Adjust camera target to zoom into mouse position
-            camera.target.x += (mouseWorldPos.x - mouseWorldPosNew.x);
-            camera.target.y += (mouseWorldPos.y - mouseWorldPosNew.y);
-        }
-    } // End if (wheel != 0)
-
-    // Pan with middle mouse button
-    if (IsMouseButtonPressed(MOUSE_MIDDLE_BUTTON)) {
-        dragStart = GetMousePosition();
-        isDragging = true;
-    }
-
-    if (IsMouseButtonReleased(MOUSE_MIDDLE_BUTTON)) {
-        isDragging = false;
+size_t Engine::GetSectCount() const {
+    size_t count = 0;
+    for (const auto& colony : colonies) {
+        count += colony->GetSects().size();
     }
+    return count;
+}
 
-    if (isDragging) {
-        Vector2 delta = GetMouseDelta();
-        camera.target.x -= delta.x / camera.zoom;
-        camera.target.y -= delta.y / camera.zoom;
+void Engine::StartSimulation() {
+    if (simRunning) {
+        return;
     }
 
-    // Apply bounds
-    ClampCamera();
+    // The first snapshot is built here so the first frame already has a world to draw
+    simRateWindowStart = SimClock();
+    PublishSnapshot();
+    view = &snapshots.GetFront();
 
-    // Reset view based on current mode
-    if (IsKeyPressed(KEY_R)) {
-        ResetCameraForCurrentView();
-    }
+    simRunning = true;
+    simThread = std::thread(&Engine::SimulationLoop, this);
 }
 
-void Engine::ResetCameraForCurrentView() {
-    switch (currentView) {
-        case View::Planet: {
-            // Calculate zoom to fit planet
-            float zoomX = screenWidth / PLANET_WIDTH;
-            float zoomY = screenHeight / PLANET_HEIGHT;
-            camera.zoom = std::min(zoomX, zoomY) * 0.95f; // 95% to add slight padding
-
-            // Center on planet
-            camera.target = {PLANET_WIDTH/2, PLANET_HEIGHT/2};
-            break;
-        }
-
-        case View::Colony: {
-            if (currentColony) {
-                // Center on colony
-                camera.target = currentColony->GetCentroid();
-
-                camera.zoom = 1.0f; // Or whatever zoom level works best for colony view
-
-                // Ensure bounds are respected
-                ClampCamera();
-            }
-            break;
-        }
-        default:
-            break;
+void Engine::StopSimulation() {
+    simRunning = false;
+    if (simThread.joinable()) {
+        simThread.join();
     }
 }
 
-void Engine::Update() {
-    // For now, we can leave it empty or add basic update logic
-    /*
-    if (currentColony) {
-        currentColony->Update();
-    }
+void Engine::SimulationLoop() {
+    // Fixed-timestep simulation: the economy advances in SIM_TIMESTEP ticks,
+    // independent of the render frame rate
+    double previous = SimClock();
 
-    if (currentSect) {
-        currentSect->Update();
-    }
+    while (simRunning.load(std::memory_order_acquire)) {
+        double batchStart = SimClock();
+        double elapsed = std::min(batchStart - previous, static_cast<double>(MAX_FRAME_TIME));
+        previous = batchStart;
+        float scale = timeScale.load(std::memory_order_relaxed);
 
-    if (currentUnit) {
-        currentUnit->Update();
-    }*/
-}
+        {
+            std::lock_guard<std::mutex> lock(worldMutex);
 
-void Engine::UpdatePlanetActiveArea() {
-    if (planet) {
-        planet->UpdateActiveArea(colonies);
-    }
-}
+            if (scale > 0.0f) {
+                simAccumulator += elapsed * scale;
 
-void Engine::Draw() {
-    BeginDrawing();
-    ClearBackground(RAYWHITE);
-
-    switch (currentView) {
-        case View::Menu:
-            DrawText("COLONY", GetScreenWidth()/2 - MeasureText("COLONY", 60)/2, GetScreenHeight()/3, 60, BLACK);
-            DrawText("Press ENTER to start", GetScreenWidth()/2 - MeasureText("Press ENTER to start", 20)/2, GetScreenHeight()/2, 20, GRAY);
-            break;
-        case View::Planet:{
-            BeginMode2D(camera);
-
-            if (planet) {  // Guard against null planet
-                // Draw grid
-                for (int i = 0; i <= PLANET_SIZE; i++) {
-                    float linePos = i * SECT_CORE_RADIUS * 2;
-                    DrawLineV({linePos, 0}, {linePos, PLANET_HEIGHT}, LIGHTGRAY);
-                    DrawLineV({0, linePos}, {PLANET_WIDTH, linePos}, LIGHTGRAY);
-                }
+                while (simAccumulator >= SIM_TIMESTEP) {
+                    Tick();
+                    simAccumulator -= SIM_TIMESTEP;
+                    simTicksThisSecond++;
 
-                // Draw colonies if any
-                for (const auto& colony : colonies) {
-                    colony->Draw(camera.zoom);
+                    // Out of budget: drop the backlog instead of spiralling
+                    if (SimClock() - batchStart > SIM_FRAME_BUDGET) {
+                        simAccumulator = std::fmod(simAccumulator, static_cast<double>(SIM_TIMESTEP));
+                        break;
+                    }
                 }
-
+            } else {
+                // Max speed: tick for the whole batch budget
+                do {
+                    Tick();
+                    simTicksThisSecond++;
+                } while (SimClock() - batchStart < SIM_FRAME_BUDGET);
+                simAccumulator = 0.0;
             }
 
+            // Measure the achieved simulation rate once per second
+            double now = SimClock();
+            if (now - simRateWindowStart >= 1.0) {
+                simTicksPerSecond = static_cast<float>(simTicksThisSecond / (now - simRateWindowStart));
+                simTicksThisSecond = 0;
+                simRateWindowStart = now;
             }
 
-            EndMode2D();
+            PublishSnapshot();
+        }
 
-            DrawText("Planet View", 10, 10, 20, BLACK);
-            DrawText("Press C for Colony View", 10, 40, 20, GRAY);
-            break;
+        if (scale > 0.0f) {
+            // Sleep until the next tick is due, but wake up often enough to notice speed changes
+            double wait = (SIM_TIMESTEP - simAccumulator) / scale;
+            std::this_thread::sleep_for(std::chrono::duration<double>(std::min(wait, 0.005)));
+        } else {
+            // Give a render thread waiting on worldMutex a chance to take it
+            std::this_thread::yield();
         }
+    }
+}
 
+void Engine::PublishSnapshot() {
+    PROFILE_SCOPE("Engine::PublishSnapshot");
 
-        case View::Colony:{
-            // Start drawing with camera transformation
-            BeginMode2D(camera);
-
-            if (currentColony) {
-                // Calculate visible area in world coordinates
-                Vector2 topLeft = GetScreenToWorld2D({0, 0}, camera);
-                Vector2 bottomRight = GetScreenToWorld2D(
-                    {static_cast<float>(screenWidth),
-                     static_cast<float>(screenHeight)},
-                    camera
-                );
-
-                // Calculate grid line positions
-                float cellSize = SECT_CORE_RADIUS * 2.0f;
-                float planetWidth = PLANET_SIZE * cellSize;  // Total width of planet
-                float planetHeight = PLANET_SIZE * cellSize; // Total height of planet
-
-                // Draw vertical grid lines
-                int startX = std::max(0, static_cast<int>(topLeft.x / cellSize));
-                int endX = std::min(PLANET_SIZE, static_cast<int>(bottomRight.x / cellSize) + 1);
-
-                for (int i = startX; i <= endX; i++) {
-                    float x = i * cellSize;
-                    if (x <= planetWidth) {  // Only draw if within planet width
-                        Vector2 start = {x, 0};
-                        Vector2 end = {x, planetHeight};
-                        DrawLineV(start, end, Fade(LIGHTGRAY, 0.5f));
-                    }
-                }
+    // Runs on the simulation thread, or on the main thread before it starts
+    UpdatePlanetActiveArea();
 
-                // Draw horizontal grid lines
-                int startY = std::max(0, static_cast<int>(topLeft.y / cellSize));
-                int endY = std::min(PLANET_SIZE, static_cast<int>(bottomRight.y / cellSize) + 1);
-
-                for (int i = startY; i <= endY; i++) {
-                    float y = i * cellSize;
-                    // Draw horizontal line from 0 to planetWidth (not screen width)
-                    DrawLineV(
-                        {0, y},
-                        {planetWidth, y},
-                        Fade(LIGHTGRAY, 0.5f)
-                    );
-                }
+    WorldSnapshot& snapshot = snapshots.GetBack();
+    snapshot.tick = simTick;
+    snapshot.publishTime = SimClock();
+    snapshot.accumulator = simAccumulator;
+    snapshot.ticksPerSecond = simTicksPerSecond;
+    snapshot.activeCentroid = planet->GetActiveCentroid();
+    snapshot.activeRadius = planet->GetActiveRadius();
+
+    // Colony ranges first, then every colony copies its sects into its own range.
+    // The slots and grid buckets are reused, so after the first rounds this does not
+    // allocate unless a colony's centroid moves to a new grid cell.
+    snapshot.colonies.clear();
+    snapshot.colonyGrid.Clear();
+    snapshot.maxColonyRadius = 0.0f;
+    sectGrids.resize(colonies.size());
+    sectGridVersions.resize(colonies.size());
+    size_t sectCount = 0;
+    for (size_t c = 0; c < colonies.size(); c++) {
+        Colony* colony = colonies[c];
+
+        // The colony keeps its sect index current; copy it only when the layout changed
+        if (!sectGrids[c] || sectGridVersions[c] != colony->GetLayoutVersion()) {
+            sectGrids[c] = std::make_shared<SpatialGrid>(colony->GetSectGrid());
+            sectGridVersions[c] = colony->GetLayoutVersion();
+        }
 
-                // Draw all sects in the current colony
-                for (const auto& sect : currentColony->GetSects()) {
-                    sect->DrawInColonyView(sect->GetPosition(), camera.zoom);
-                }
+        ColonySnapshot entry;
+        entry.colony = colony;
+        entry.centroid = colony->GetCentroid();
+        entry.radius = colony->GetRadius();
+        entry.firstSect = sectCount;
+        entry.sectCount = colony->GetSects().size();
+        entry.resources = colony->GetAvailableResources();
+        entry.development = colony->GetAverageDevelopment();
+        entry.sectGrid = sectGrids[c];
+        snapshot.colonies.push_back(entry);
+        snapshot.colonyGrid.Insert(static_cast<uint32_t>(c), entry.centroid);
+        snapshot.maxColonyRadius = std::max(snapshot.maxColonyRadius, entry.radius);
+        sectCount += entry.sectCount;
+    }
+    snapshot.sects.resize(sectCount);
+
+    JobSystem::Global().ParallelFor(colonies.size(), 1, [this, &snapshot](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; c++) {
+            const std::vector<Sect*>& sects = colonies[c]->GetSects();
+            SectSnapshot* out = &snapshot.sects[snapshot.colonies[c].firstSect];
+            for (size_t i = 0; i < sects.size(); i++) {
+                out[i] = sects[i]->GetSnapshot();
+                out[i].sect = sects[i];
             }
+        }
+    });
+
+    const Sect* focus = focusedSect.load(std::memory_order_relaxed);
+    snapshot.focusedSect = focus;
+    if (focus) {
+        snapshot.focusedSectState = focus->GetViewState();
+    }
 
-            // End camera transformation
-            EndMode2D();
+    snapshots.Publish();
+}
 
-            DrawText("Colony View", 10, 10, 20, BLACK);
-            DrawText("Press S for Sect View", 10, 40, 20, GRAY);
-            DrawText("Press P for Planet View", 10, 70, 20, GRAY);
-            break;
+const ColonySnapshot* Engine::FindColonySnapshot(const Colony* colony) const {
+    for (const auto& entry : view->colonies) {
+        if (entry.colony == colony) {
+            return &entry;
         }
+    }
+    return nullptr;
+}
 
+void Engine::Tick() {
+    PROFILE_SCOPE("Engine::Tick");
 
+    simTick++;
 
-        case View::Sect:
-            if (currentSect) {
-                currentSect->DrawInSectView(Vector2{GetScreenWidth()/2.0f, GetScreenHeight()/2.0f});
-            }
-            DrawText("Sect View", 10, 10, 20, BLACK);
-            DrawText("Press U for Unit View", 10, 40, 20, GRAY);
-            DrawText("Press C for Colony View", 10, 70, 20, GRAY);
-            break;
-        case View::Unit:
-            if (currentUnit) {
-                currentUnit->DrawInUnitView();
+    // One simulation step of the whole world, independent of any window
+    if (planet) {
+        planet->Update();
+
+        // Keep the planet chunks around the camera and the colonies in memory
+        if (simTick % CHUNK_STREAM_INTERVAL == 0) {
+            Rectangle view;
+            {
+                std::lock_guard<std::mutex> lock(streamViewMutex);
+                view = streamView;
             }
-            DrawText("Unit View", 10, 10, 20, BLACK);
-            DrawText("Press S for Sect View", 10, 40, 20, GRAY);
-            break;
+            planet->StreamChunks(view);
+        }
     }
 
+    // Production and consumption of every unit in one batched pass
+    UnitStore::Global().Tick();
 
-    // Draw UI elements (not affected by camera)
-    DrawText(TextFormat("Zoom: %.2f", camera.zoom), 10, screenHeight - 20, 20, GRAY);
-    DrawText("Double-click to select", 10, GetScreenHeight() - 40, 20, DARKGRAY);
-
-
-    EndDrawing();
+    // Colonies tick in parallel, and each colony ticks its sects in parallel
+    JobSystem::Global().ParallelFor(colonies.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            colonies[i]->Update();
+        }
+    });
+
+    // Merge phase once every sect has ticked: each colony applies the transfers
+    // its sects queued, which stay within the colony, then sums its totals
+    JobSystem::Global().ParallelFor(colonies.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            colonies[i]->ApplyTransfers();
+            colonies[i]->ManageResources();
+        }
+    });
 }
 
+void Engine::UpdatePlanetActiveArea() {
+    if (planet) {
+        planet->UpdateActiveArea(colonies);
+    }
+}
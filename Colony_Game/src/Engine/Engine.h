@@ -3,11 +3,20 @@
 
 #include "raylib.h"
 #include "raymath.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 #include "planet.h"
 #include "colony.h"
 #include "sect.h"
 #include "unit.h"
+#include "triple_buffer.h"
+#include "world_snapshot.h"
+
+class PlanetGridLayer;
 
 enum class View {
     Menu,
@@ -19,15 +28,24 @@ enum class View {
 
 class Engine {
 public:
-    Engine(int screenWidth, int screenHeight, const char* title);
+    // The window opens in Run. A headless engine never opens one: no input, no
+    // drawing, only simulation ticks, and it links without the window code.
+    Engine(int screenWidth, int screenHeight, const char* title, bool headless = false);
     ~Engine();
 
     void InitGame();
     void Run();
+    void ConfigurePlanet(const PlanetConfig& config);  // Before Run; the world size comes from the planet
+
+    // Headless mode
+    void PopulateWorld(int colonyCount, int sectsPerColony);
+    void RunHeadless(long ticks, const char* tracePath = nullptr);  // Optionally writes a Chrome trace
+    bool IsHeadless() const { return headless; }
+    size_t GetSectCount() const;
 
 private:
     void HandleInput();
-    void Update();
+    void Tick();
     void Draw();
 
     bool IsDoubleClick();
@@ -39,15 +57,26 @@ private:
     void SelectSect(Vector2 mousePosition);
     void SelectUnit(Vector2 mousePosition);
 
+    // Picking against the current snapshot's spatial indices
+    int FindColonyAt(Vector2 worldPosition) const;  // Index into view->colonies, -1 if none
+    int FindSectAt(const ColonySnapshot& colony, Vector2 worldPosition) const;  // Index within the colony, -1 if none
+    void UpdateHover();
+    void DrawHoverHighlight();
+
     int screenWidth;
     int screenHeight;
+    bool headless;
+    std::string title;  // Of the window Run opens
     View currentView;  // Changed from currentState to currentView
 
     Planet* planet;
+    PlanetGridLayer* gridLayer;  // Exists while Run has the window open
     std::vector<Colony*> colonies;
     Colony* currentColony;
     Sect* currentSect;
     Unit* currentUnit;
+    int hoveredColony;  // Recomputed every frame, indices into the current snapshot
+    int hoveredSect;
 
     // Camera state
     Camera2D camera;
@@ -64,12 +93,66 @@ private:
     Vector2 GetWorldMousePosition();
     void UpdatePlanetActiveArea();
 
-
-    // Constants for the world
-    const float SECT_CORE_RADIUS = 50.0f;
-    const int PLANET_SIZE = 20; // 20x20 grid of possible sect locations
-    const float PLANET_WIDTH = PLANET_SIZE * SECT_CORE_RADIUS * 2.0f;  // Total width of planet
-    const float PLANET_HEIGHT = PLANET_SIZE * SECT_CORE_RADIUS * 2.0f; // Total height of planet
+    // Simulation thread. It owns the world while running: it ticks at a fixed
+    // timestep and publishes a WorldSnapshot after every batch of ticks. The
+    // render thread draws only from snapshots and takes worldMutex for the rare
+    // input that has to change the world.
+    void StartSimulation();
+    void StopSimulation();
+    void SimulationLoop();
+    void PublishSnapshot();
+    static double SimClock();  // Seconds on a monotonic clock shared by the simulation and render threads
+    const ColonySnapshot* FindColonySnapshot(const Colony* colony) const;
+
+    // Frustum culling: what the camera can see, rebuilt every frame from the
+    // snapshot's spatial indices so draw cost follows the screen, not the planet
+    Rectangle GetVisibleWorldRect() const;
+    void UpdateVisibleSet();
+    void CollectVisibleSects(const ColonySnapshot& colony, Rectangle visible);
+    void DrawVisible();
+    std::vector<size_t> visibleColonies;  // Indices into view->colonies
+    std::vector<size_t> visibleSects;     // Indices into view->sects, in snapshot order
+    SectDetail sectDetail;                // Level of detail for this frame's zoom
+    std::vector<SectDrawItem> drawItems;  // Reused every frame
+
+    // Owned by the simulation thread: each colony's sect index as last published
+    std::vector<std::shared_ptr<const SpatialGrid>> sectGrids;
+    std::vector<uint64_t> sectGridVersions;
+
+    std::thread simThread;
+    std::atomic<bool> simRunning;
+    std::atomic<float> timeScale;         // Game seconds per real second, 0 = as fast as possible
+    std::atomic<const Sect*> focusedSect; // Sect copied in full into each snapshot
+    std::mutex worldMutex;                // Held by the simulation thread while it touches the world
+    std::mutex streamViewMutex;
+    Rectangle streamView;                 // World area on screen, where the simulation streams planet chunks
+    TripleBuffer<WorldSnapshot> snapshots;
+    const WorldSnapshot* view;            // Newest snapshot, taken at the start of each frame
+    float simAlpha;                       // Render interpolation factor between the last two ticks
+
+    // Owned by the simulation thread
+    long simTick;
+    double simAccumulator;       // Unsimulated game time carried between batches
+    long simTicksThisSecond;     // Ticks run since simRateWindowStart
+    double simRateWindowStart;
+    float simTicksPerSecond;     // Measured simulation rate shown in the HUD
+
+    void HandleTimeScaleControls();
+    const char* GetTimeScaleLabel() const;
+
+    // Profiler overlay (F3) and trace capture (F4)
+    bool showProfiler;
+    void HandleProfilerControls();
+    void DrawProfilerOverlay();
+
+
+    // Constants for the simulation clock
+    const float SIM_TIMESTEP = 1.0f / 60.0f;      // Game seconds per tick
+    const float MAX_FRAME_TIME = 0.25f;           // Longest frame we try to catch up on
+    const double SIM_FRAME_BUDGET = 0.012;        // Real seconds per batch, bounds snapshot latency
+    const long CHUNK_STREAM_INTERVAL = 15;        // Ticks between planet chunk streaming passes
+    const float SHIPMENT_AMOUNT = 1.0f;           // Iron per tick each PopulateWorld sect ships
+    const char* TRACE_FILE = "colony_trace.json";
 
     // Double-click detection
     double lastClickTime;
@@ -0,0 +1,613 @@
+#include "Engine.h"
+
+#include "log.h"
+#include "profiler.h"
+#include "planet_grid_layer.h"
+#include <algorithm>
+#include <cmath>
+
+void Engine::Run() {
+    if (headless) {
+        LOG_WARNING("Engine::Run needs a window, use RunHeadless instead.");
+        return;
+    }
+
+    // The window, and the GPU resources drawn into it, live as long as Run
+    InitWindow(screenWidth, screenHeight, title.c_str());
+    SetTargetFPS(60);
+    gridLayer = new PlanetGridLayer();
+
+    StartSimulation();
+
+    while (!WindowShouldClose()) {
+        {
+            PROFILE_SCOPE("Frame");
+            view = &snapshots.GetFront();
+            HandleInput();
+            Draw();
+        }
+        Profiler::Global().EndFrame();
+    }
+
+    StopSimulation();
+
+    if (Profiler::Global().IsCapturing()) {
+        Profiler::Global().EndCapture(TRACE_FILE);
+    }
+
+    delete gridLayer;  // Before the window, and with it the GL context, closes
+    gridLayer = nullptr;
+    CloseWindow();
+}
+
+bool Engine::IsDoubleClick() {
+    double currentTime = GetTime();
+    Vector2 currentPosition = GetMousePosition();
+
+    bool isDoubleClick = (currentTime - lastClickTime <= 0.5) &&
+                         (Vector2Distance(lastClickPosition, currentPosition) <= 10);
+
+    lastClickTime = currentTime;
+    lastClickPosition = currentPosition;
+
+    return isDoubleClick;
+}
+
+void Engine::SwitchToColonyView() {
+    if (currentColony) {
+        currentView = View::Colony;
+    }
+}
+
+void Engine::SwitchToSectView() {
+    if (currentColony && currentSect) {
+        currentView = View::Sect;
+        focusedSect.store(currentSect, std::memory_order_relaxed);
+    }
+}
+
+void Engine::SwitchToUnitView() {
+    if (currentColony && currentSect && currentUnit) {
+        currentView = View::Unit;
+    }
+}
+
+void Engine::SwitchToPlanetView() {
+    currentView = View::Planet;  // The active area arrives with every snapshot
+    ResetCameraForCurrentView();
+}
+
+void Engine::SelectColony(Vector2 mousePosition) {
+    // Logic to determine which colony was clicked
+    int index = FindColonyAt(GetScreenToWorld2D(mousePosition, camera));
+    if (index >= 0) {
+        currentColony = view->colonies[index].colony;
+        SwitchToColonyView();
+    }
+}
+
+void Engine::SelectSect(Vector2 mousePosition) {
+    // Logic to determine which sect was clicked
+    const ColonySnapshot* colony = FindColonySnapshot(currentColony);
+    if (colony) {
+        // Convert screen coordinates to world coordinates using the camera
+        int index = FindSectAt(*colony, GetScreenToWorld2D(mousePosition, camera));
+        if (index >= 0) {
+            // The live sect list may have changed since the snapshot, so take the sect from it
+            currentSect = view->sects[colony->firstSect + index].sect;
+            SwitchToSectView();
+        }
+    }
+}
+
+int Engine::FindColonyAt(Vector2 worldPosition) const {
+    // Candidates are colonies whose centroid is within the largest radius,
+    // the nearest one that actually covers the point wins
+    int found = -1;
+    float best = 0.0f;
+    view->colonyGrid.ForEachInRadius(worldPosition, view->maxColonyRadius, [&](const SpatialGrid::Entry& entry) {
+        const ColonySnapshot& colony = view->colonies[entry.id];
+        float distance = Vector2Distance(worldPosition, colony.centroid);
+        if (distance <= colony.radius && (found < 0 || distance < best)) {
+            found = static_cast<int>(entry.id);
+            best = distance;
+        }
+    });
+    return found;
+}
+
+int Engine::FindSectAt(const ColonySnapshot& colony, Vector2 worldPosition) const {
+    if (!colony.sectGrid || colony.sectCount == 0) {
+        return -1;
+    }
+
+    // Sects are drawn scaled by the zoom, and every sect has the same core radius
+    float radius = view->sects[colony.firstSect].coreRadius * camera.zoom;
+    uint32_t index;
+    if (!colony.sectGrid->FindNearest(worldPosition, radius, index) || index >= colony.sectCount) {
+        return -1;
+    }
+    return static_cast<int>(index);
+}
+
+void Engine::UpdateHover() {
+    hoveredColony = -1;
+    hoveredSect = -1;
+
+    Vector2 worldMousePos = GetScreenToWorld2D(GetMousePosition(), camera);
+    if (currentView == View::Planet) {
+        hoveredColony = FindColonyAt(worldMousePos);
+    } else if (currentView == View::Colony) {
+        const ColonySnapshot* colony = FindColonySnapshot(currentColony);
+        if (colony) {
+            int index = FindSectAt(*colony, worldMousePos);
+            if (index >= 0) {
+                hoveredSect = static_cast<int>(colony->firstSect) + index;
+            }
+        }
+    }
+}
+
+void Engine::DrawHoverHighlight() {
+    // Inside BeginMode2D: outline the colony or sect under the mouse
+    float width = 3.0f / camera.zoom;
+    if (hoveredColony >= 0) {
+        const ColonySnapshot& colony = view->colonies[hoveredColony];
+        DrawRing(colony.centroid, colony.radius, colony.radius + width, 0, 360, 64, ORANGE);
+    }
+    if (hoveredSect >= 0) {
+        const SectSnapshot& sect = view->sects[hoveredSect];
+        float radius = sect.coreRadius * camera.zoom;
+        DrawRing(sect.position, radius, radius + width, 0, 360, 32, ORANGE);
+    }
+}
+
+void Engine::SelectUnit(Vector2 mousePosition) {
+    // Logic to determine which unit was clicked
+    if (currentSect) {
+        int slot = currentSect->GetUnitSlotAt(mousePosition);
+        if (slot >= 0) {
+            // Inspecting a placeholder materializes it so the unit view has a record.
+            // That writes to the unit store, so wait for the simulation to finish its batch.
+            std::lock_guard<std::mutex> lock(worldMutex);
+            currentUnit = currentSect->GetUnit(static_cast<UnitType>(slot));
+            SwitchToUnitView();
+        }
+    }
+}
+
+void Engine::HandleInput() {
+    PROFILE_SCOPE("Engine::HandleInput");
+
+    HandleCameraControls();  // Always handle camera controls first
+    HandleTimeScaleControls();
+    HandleProfilerControls();
+    UpdateHover();
+
+    switch (currentView) {
+        case View::Menu:
+            if (IsKeyPressed(KEY_ENTER)) {
+                SwitchToColonyView();
+            }
+            break;
+        case View::Planet:
+            if (IsKeyPressed(KEY_C)) {
+                SwitchToColonyView();
+            }
+            break;
+        case View::Colony:
+            if (IsKeyPressed(KEY_S)) {
+                SwitchToSectView();
+            }
+            if (IsKeyPressed(KEY_P)) {
+                SwitchToPlanetView();
+            }
+            break;
+        case View::Sect:
+            if (IsKeyPressed(KEY_U)) {
+                SwitchToUnitView();
+            }
+            if (IsKeyPressed(KEY_C)) {
+                SwitchToColonyView();
+            }
+            break;
+        case View::Unit:
+            if (IsKeyPressed(KEY_S)) {
+                SwitchToSectView();
+            }
+            break;
+    }
+
+    // Handle double-click selection of specific colonies, sects, and units
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && IsDoubleClick()) {
+        Vector2 mousePosition = GetMousePosition();
+        switch (currentView) {
+            case View::Planet:
+                SelectColony(mousePosition);
+                break;
+            case View::Colony:
+                SelectSect(mousePosition);
+                break;
+            case View::Sect:
+                SelectUnit(mousePosition);
+                break;
+            case View::Unit:
+                // Handle double-click in Unit view if needed
+                break;
+            case View::Menu:
+                // Handle double-click in Menu if needed
+                break;
+        }
+    }
+}
+
+void Engine::ClampCamera() {
+    float planetWidth = planet->GetConfig().GetWorldWidth();
+    float planetHeight = planet->GetConfig().GetWorldHeight();
+
+    // Calculate visible area in world coordinates
+    float visibleWidth = screenWidth / camera.zoom;
+    float visibleHeight = screenHeight / camera.zoom;
+
+    // Calculate bounds considering visible area
+    float minX = visibleWidth / 2;
+    float minY = visibleHeight / 2;
+    float maxX = planetWidth - (visibleWidth / 2);
+    float maxY = planetHeight - (visibleHeight / 2);
+
+    // Adjust bounds when zoomed out
+    if (visibleWidth >= planetWidth) {
+        camera.target.x = planetWidth / 2;
+    } else {
+        camera.target.x = Clamp(camera.target.x, minX, maxX);
+    }
+
+    if (visibleHeight >= planetHeight) {
+        camera.target.y = planetHeight / 2;
+    } else {
+        camera.target.y = Clamp(camera.target.y, minY, maxY);
+    }
+}
+
+void Engine::HandleCameraControls() {
+    // Mouse wheel zooming
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0) {
+        // Get world point before zoom
+        Vector2 mouseWorldPos = GetScreenToWorld2D(GetMousePosition(), camera);
+
+        // Modify zoom. Steps are relative so a large planet is as quick to cross as a small one.
+        float prevZoom = camera.zoom;
+        camera.zoom *= std::pow(1.1f, wheel);
+
+        // Calculate max zoom out to see whole planet
+        float maxZoomOut = std::min(
+            screenWidth / planet->GetConfig().GetWorldWidth(),
+            screenHeight / planet->GetConfig().GetWorldHeight()
+        );
+
+        // Clamp zoom between max zoom out and maxZoom
+        camera.zoom = Clamp(camera.zoom, maxZoomOut, maxZoom);
+
+        // Only adjust position if zoom actually changed
+        if (camera.zoom != prevZoom) {
+            // Get world point after zoom
+            Vector2 mouseWorldPosNew = GetScreenToWorld2D(GetMousePosition(), camera);
+
+            // Adjust camera target to zoom into mouse position
+            camera.target.x += (mouseWorldPos.x - mouseWorldPosNew.x);
+            camera.target.y += (mouseWorldPos.y - mouseWorldPosNew.y);
+        }
+    } // End if (wheel != 0)
+
+    // Pan with middle mouse button
+    if (IsMouseButtonPressed(MOUSE_MIDDLE_BUTTON)) {
+        dragStart = GetMousePosition();
+        isDragging = true;
+    }
+
+    if (IsMouseButtonReleased(MOUSE_MIDDLE_BUTTON)) {
+        isDragging = false;
+    }
+
+    if (isDragging) {
+        Vector2 delta = GetMouseDelta();
+        camera.target.x -= delta.x / camera.zoom;
+        camera.target.y -= delta.y / camera.zoom;
+    }
+
+    // Apply bounds
+    ClampCamera();
+
+    // Reset view based on current mode
+    if (IsKeyPressed(KEY_R)) {
+        ResetCameraForCurrentView();
+    }
+}
+
+void Engine::ResetCameraForCurrentView() {
+    switch (currentView) {
+        case View::Planet: {
+            // Calculate zoom to fit planet
+            const PlanetConfig& world = planet->GetConfig();
+            float zoomX = screenWidth / world.GetWorldWidth();
+            float zoomY = screenHeight / world.GetWorldHeight();
+            float fitPlanet = std::min(zoomX, zoomY);
+
+            if (view->activeRadius > 0.0f) {
+                // Frame the colonies' enclosing circle, never closer than colony zoom
+                float fitArea = std::min(screenWidth, screenHeight) / (2.0f * view->activeRadius);
+                camera.zoom = Clamp(fitArea * 0.95f, fitPlanet, 1.0f); // 95% to add slight padding
+                camera.target = view->activeCentroid;
+                ClampCamera();
+            } else {
+                camera.zoom = fitPlanet * 0.95f;
+
+                // Center on planet
+                camera.target = world.GetWorldCenter();
+            }
+            break;
+        }
+
+        case View::Colony: {
+            const ColonySnapshot* colony = FindColonySnapshot(currentColony);
+            if (colony) {
+                // Center on colony
+                camera.target = colony->centroid;
+
+                camera.zoom = 1.0f; // Or whatever zoom level works best for colony view
+
+                // Ensure bounds are respected
+                ClampCamera();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Engine::HandleTimeScaleControls() {
+    if (IsKeyPressed(KEY_ONE)) timeScale.store(1.0f);
+    if (IsKeyPressed(KEY_TWO)) timeScale.store(10.0f);
+    if (IsKeyPressed(KEY_THREE)) timeScale.store(100.0f);
+    if (IsKeyPressed(KEY_FOUR)) timeScale.store(0.0f);  // Max speed
+}
+
+void Engine::HandleProfilerControls() {
+    if (IsKeyPressed(KEY_F3)) {
+        showProfiler = !showProfiler;
+    }
+
+    // F4 starts a trace capture, pressing it again writes the file
+    if (IsKeyPressed(KEY_F4)) {
+        Profiler& profiler = Profiler::Global();
+        if (!profiler.IsCapturing()) {
+            profiler.BeginCapture();
+            LOG_INFO("Trace capture started");
+        } else if (profiler.EndCapture(TRACE_FILE)) {
+            LOG_INFO("Trace written to %s", TRACE_FILE);
+        } else {
+            LOG_ERROR("Could not write trace to %s", TRACE_FILE);
+        }
+    }
+}
+
+void Engine::DrawProfilerOverlay() {
+    std::vector<Profiler::PhaseStats> stats = Profiler::Global().GetStats();
+
+    int x = screenWidth - 470;
+    int y = 10;
+    int lineHeight = 18;
+    DrawRectangle(x - 10, y - 5, 470, lineHeight * (static_cast<int>(stats.size()) + 2) + 10, Fade(BLACK, 0.7f));
+
+    DrawText(TextFormat("Phase (ms/frame, last %d)       p50     p95     p99     max",
+                        static_cast<int>(Profiler::FRAME_HISTORY)),
+             x, y, 10, LIGHTGRAY);
+    y += lineHeight;
+
+    for (const auto& phase : stats) {
+        DrawText(phase.name.c_str(), x, y, 10, RAYWHITE);
+        DrawText(TextFormat("%7.2f %7.2f %7.2f %7.2f", phase.p50, phase.p95, phase.p99, phase.max),
+                 x + 190, y, 10, RAYWHITE);
+        y += lineHeight;
+    }
+
+    DrawText(Profiler::Global().IsCapturing() ? "Capturing trace... [F4] stop" : "[F4] capture trace",
+             x, y, 10, Profiler::Global().IsCapturing() ? RED : LIGHTGRAY);
+}
+
+const char* Engine::GetTimeScaleLabel() const {
+    float scale = timeScale.load();
+    if (scale <= 0.0f) {
+        return "max";
+    }
+    return TextFormat("%.0fx", scale);
+}
+
+Rectangle Engine::GetVisibleWorldRect() const {
+    Vector2 topLeft = GetScreenToWorld2D({0, 0}, camera);
+    Vector2 bottomRight = GetScreenToWorld2D({static_cast<float>(screenWidth), static_cast<float>(screenHeight)}, camera);
+    return {topLeft.x, topLeft.y, bottomRight.x - topLeft.x, bottomRight.y - topLeft.y};
+}
+
+void Engine::UpdateVisibleSet() {
+    PROFILE_SCOPE("Engine::UpdateVisibleSet");
+
+    visibleColonies.clear();
+    visibleSects.clear();
+    Rectangle visible = GetVisibleWorldRect();
+    if (currentView == View::Planet || currentView == View::Colony) {
+        std::lock_guard<std::mutex> lock(streamViewMutex);
+        streamView = visible;
+    }
+
+    // Sects are scaled by the zoom and then drawn under the camera, so a core covers radius * zoom² pixels
+    float coreRadius = view->sects.empty() ? 0.0f : view->sects.front().coreRadius;
+    sectDetail = Sect::GetColonyViewDetail(coreRadius * camera.zoom * camera.zoom);
+
+    if (currentView == View::Planet) {
+        // A colony is visible if its footprint, widened by the sects' indicators, meets the screen
+        float reach = view->sects.empty() ? 0.0f : view->sects.front().coreRadius * camera.zoom * Sect::COLONY_VIEW_REACH;
+        float pad = view->maxColonyRadius + reach;
+        view->colonyGrid.ForEachInRect({visible.x - pad, visible.y - pad},
+                                       {visible.x + visible.width + pad, visible.y + visible.height + pad},
+                                       [&](const SpatialGrid::Entry& entry) {
+            const ColonySnapshot& colony = view->colonies[entry.id];
+            if (CheckCollisionCircleRec(colony.centroid, colony.radius + reach, visible)) {
+                visibleColonies.push_back(entry.id);
+            }
+        });
+        std::sort(visibleColonies.begin(), visibleColonies.end());
+
+        if (sectDetail != SectDetail::Colony) {
+            for (size_t index : visibleColonies) {
+                CollectVisibleSects(view->colonies[index], visible);
+            }
+        }
+    } else if (currentView == View::Colony) {
+        const ColonySnapshot* colony = FindColonySnapshot(currentColony);
+        if (colony && sectDetail == SectDetail::Colony) {
+            if (CheckCollisionCircleRec(colony->centroid, colony->radius, visible)) {
+                visibleColonies.push_back(colony - view->colonies.data());
+            }
+        } else if (colony) {
+            CollectVisibleSects(*colony, visible);
+        }
+    }
+}
+
+void Engine::CollectVisibleSects(const ColonySnapshot& colony, Rectangle visible) {
+    if (!colony.sectGrid || colony.sectCount == 0) {
+        return;
+    }
+
+    Colony::CollectVisibleSects(*colony.sectGrid, colony.sectCount, view->sects[colony.firstSect].coreRadius,
+                                camera.zoom, visible, colony.firstSect, visibleSects);
+}
+
+void Engine::DrawVisible() {
+    // At planet zoom each colony is one impostor and visibleSects is empty
+    if (sectDetail == SectDetail::Colony) {
+        for (size_t index : visibleColonies) {
+            const ColonySnapshot& colony = view->colonies[index];
+            Colony::DrawImpostor(colony.centroid, colony.radius, colony.development);
+        }
+    }
+
+    drawItems.clear();
+    for (size_t index : visibleSects) {
+        drawItems.push_back(Sect::BuildColonyViewItem(view->sects[index], camera.zoom, simAlpha));
+    }
+    Sect::DrawColonyViewItems(drawItems.data(), drawItems.size(), sectDetail);
+}
+
+void Engine::Draw() {
+    PROFILE_SCOPE("Engine::Draw");
+
+    // Interpolate between the snapshot's last two ticks by the game time
+    // that has passed since it was published
+    float scale = timeScale.load(std::memory_order_relaxed);
+    if (scale > 0.0f) {
+        double pending = view->accumulator + (SimClock() - view->publishTime) * scale;
+        simAlpha = Clamp(static_cast<float>(pending / SIM_TIMESTEP), 0.0f, 1.0f);
+    } else {
+        simAlpha = 1.0f;
+    }
+
+    UpdateVisibleSet();
+
+    // Render-to-texture has to happen before the camera is applied
+    if (planet && (currentView == View::Planet || currentView == View::Colony)) {
+        gridLayer->Update(planet->GetConfig(), camera.zoom);
+    }
+
+    BeginDrawing();
+    ClearBackground(RAYWHITE);
+
+    switch (currentView) {
+        case View::Menu:
+            DrawText("COLONY", GetScreenWidth()/2 - MeasureText("COLONY", 60)/2, GetScreenHeight()/3, 60, BLACK);
+            DrawText("Press ENTER to start", GetScreenWidth()/2 - MeasureText("Press ENTER to start", 20)/2, GetScreenHeight()/2, 20, GRAY);
+            break;
+        case View::Planet:{
+            BeginMode2D(camera);
+
+            if (planet) {  // Guard against null planet
+                // Draw grid
+                gridLayer->Draw(planet->GetConfig(), camera.zoom, LIGHTGRAY);
+
+                // Draw the colonies on screen, if any
+                DrawVisible();
+                DrawHoverHighlight();
+            }
+
+            EndMode2D();
+
+            DrawText("Planet View", 10, 10, 20, BLACK);
+            DrawText("Press C for Colony View", 10, 40, 20, GRAY);
+            break;
+        }
+
+
+        case View::Colony:{
+            // Start drawing with camera transformation
+            BeginMode2D(camera);
+
+            const ColonySnapshot* colony = FindColonySnapshot(currentColony);
+            if (colony) {
+                // Cached grid layer, fainter than in the planet view
+                if (planet) {
+                    gridLayer->Draw(planet->GetConfig(), camera.zoom, Fade(LIGHTGRAY, 0.5f));
+                }
+
+                // Draw the sects of the current colony that are on screen
+                DrawVisible();
+                DrawHoverHighlight();
+            }
+
+            // End camera transformation
+            EndMode2D();
+
+            DrawText("Colony View", 10, 10, 20, BLACK);
+            DrawText("Press S for Sect View", 10, 40, 20, GRAY);
+            DrawText("Press P for Planet View", 10, 70, 20, GRAY);
+            break;
+        }
+
+
+
+        case View::Sect:
+            if (currentSect && view->focusedSect == currentSect) {
+                currentSect->DrawInSectView(Vector2{GetScreenWidth()/2.0f, GetScreenHeight()/2.0f},
+                                            view->focusedSectState);
+            }
+            DrawText("Sect View", 10, 10, 20, BLACK);
+            DrawText("Press U for Unit View", 10, 40, 20, GRAY);
+            DrawText("Press C for Colony View", 10, 70, 20, GRAY);
+            break;
+        case View::Unit:
+            if (currentUnit) {
+                currentUnit->DrawInUnitView();
+            }
+            DrawText("Unit View", 10, 10, 20, BLACK);
+            DrawText("Press S for Sect View", 10, 40, 20, GRAY);
+            break;
+    }
+
+
+    // Draw UI elements (not affected by camera)
+    DrawText(TextFormat("Zoom: %.2f   Sim: %.0f ticks/s (%s)   [1-4] speed   Drawn: %d sects, %d colonies",
+                        camera.zoom, view->ticksPerSecond, GetTimeScaleLabel(),
+                        static_cast<int>(visibleSects.size()),
+                        sectDetail == SectDetail::Colony ? static_cast<int>(visibleColonies.size()) : 0),
+             10, screenHeight - 20, 20, GRAY);
+    DrawText("Double-click to select", 10, GetScreenHeight() - 40, 20, DARKGRAY);
+
+    if (showProfiler) {
+        DrawProfilerOverlay();
+    }
+
+
+    EndDrawing();
+}
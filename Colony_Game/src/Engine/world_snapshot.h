@@ -0,0 +1,47 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include "raylib.h"
+#include <memory>
+#include <vector>
+#include "colony.h"
+#include "sect.h"
+#include "spatial_grid.h"
+
+// Immutable copy of what the renderer needs, published by the simulation
+// thread after every batch of ticks. Draw code reads only these, never the
+// live colonies.
+struct ColonySnapshot {
+    Colony* colony;        // For selection only, the render thread must not read it
+    Vector2 centroid;
+    float radius;
+    size_t firstSect;      // Range of this colony in WorldSnapshot::sects
+    size_t sectCount;
+    ResourceVector resources;
+    float development;     // Mean over the colony's sects
+
+    // Sect positions, ids index this colony's range. Shared by every snapshot
+    // until the colony's layout changes.
+    std::shared_ptr<const SpatialGrid> sectGrid;
+};
+
+struct WorldSnapshot {
+    long tick = 0;
+    double publishTime = 0.0;   // Simulation clock, seconds
+    double accumulator = 0.0;   // Unsimulated game time when published
+    float ticksPerSecond = 0.0f;
+
+    Vector2 activeCentroid = {0, 0};
+    float activeRadius = 0.0f;
+
+    std::vector<ColonySnapshot> colonies;
+    SpatialGrid colonyGrid;           // Colony centroids, ids index colonies
+    float maxColonyRadius = 0.0f;     // Reach of a colony query around a point
+    std::vector<SectSnapshot> sects;  // Grouped by colony
+
+    // Full state of the sect shown in the sect view
+    const Sect* focusedSect = nullptr;
+    SectViewState focusedSectState = {};
+};
+
+#endif // WORLD_SNAPSHOT_H
@@ -0,0 +1,126 @@
+#include "chunk_store.h"
+#include "log.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static size_t RoundUp(size_t value, size_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+ChunkStore::ChunkStore() : chunkCount(0), fd(-1), mapping(nullptr), mappedSize(0) {}
+
+ChunkStore::~ChunkStore() {
+    Close();
+}
+
+void ChunkStore::Reset(size_t newChunkCount) {
+    // Dropping the file drops every record; the next Write starts a fresh one
+    Close();
+    chunkCount = newChunkCount;
+}
+
+size_t ChunkStore::GetTableSize() const {
+    return RoundUp(sizeof(Header) + chunkCount * sizeof(Slot), BLOCK_SIZE);
+}
+
+bool ChunkStore::Open() {
+    const char* directory = std::getenv("TMPDIR");
+    std::string path = std::string(directory && *directory ? directory : "/tmp") + "/colony_chunks_XXXXXX";
+    fd = mkstemp(&path[0]);
+    if (fd < 0) {
+        LOG_WARNING("ChunkStore: cannot create %s: %s", path.c_str(), std::strerror(errno));
+        return false;
+    }
+    unlink(path.c_str());  // The open descriptor and mapping keep it alive
+
+    if (!Grow(GetTableSize())) {
+        Close();
+        return false;
+    }
+
+    // A new file reads as zeros, so every slot starts empty
+    Header* header = GetHeader();
+    std::memcpy(header->magic, "CLNYCHK1", sizeof(header->magic));
+    header->chunkCount = chunkCount;
+    header->dataEnd = GetTableSize();
+    return true;
+}
+
+bool ChunkStore::Grow(size_t minimumSize) {
+    size_t newSize = mappedSize > MIN_FILE_SIZE ? mappedSize : MIN_FILE_SIZE;
+    while (newSize < minimumSize) {
+        newSize *= 2;
+    }
+
+    if (ftruncate(fd, static_cast<off_t>(newSize)) != 0) {
+        LOG_WARNING("ChunkStore: cannot grow to %zu bytes: %s", newSize, std::strerror(errno));
+        return false;
+    }
+    // Map the larger file before letting go of the old mapping, so a failure loses nothing
+    void* newMapping = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (newMapping == MAP_FAILED) {
+        LOG_WARNING("ChunkStore: cannot map %zu bytes: %s", newSize, std::strerror(errno));
+        return false;
+    }
+    if (mapping) {
+        munmap(mapping, mappedSize);
+    }
+    mapping = static_cast<uint8_t*>(newMapping);
+    mappedSize = newSize;
+    return true;
+}
+
+void ChunkStore::Close() {
+    if (mapping) {
+        munmap(mapping, mappedSize);
+        mapping = nullptr;
+        mappedSize = 0;
+    }
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+}
+
+bool ChunkStore::Write(size_t chunk, const void* data, size_t size) {
+    if (!mapping && !Open()) {
+        return false;
+    }
+
+    Slot* slot = &GetSlots()[chunk];
+    if (slot->offset == 0 || size > slot->capacity) {
+        // New or grown record: a fresh block at the end, the old one is abandoned
+        size_t capacity = RoundUp(size, BLOCK_SIZE);
+        size_t offset = GetHeader()->dataEnd;
+        if (offset + capacity > mappedSize) {
+            if (!Grow(offset + capacity)) {
+                return false;
+            }
+            slot = &GetSlots()[chunk];
+        }
+        slot->offset = offset;
+        slot->capacity = static_cast<uint32_t>(capacity);
+        GetHeader()->dataEnd = offset + capacity;
+    }
+
+    std::memcpy(mapping + slot->offset, data, size);
+    slot->size = static_cast<uint32_t>(size);
+    return true;
+}
+
+const uint8_t* ChunkStore::Read(size_t chunk, size_t& size) const {
+    if (!mapping) {
+        return nullptr;
+    }
+    const Slot& slot = GetSlots()[chunk];
+    if (slot.offset == 0) {
+        return nullptr;
+    }
+    size = slot.size;
+    return mapping + slot.offset;
+}
@@ -0,0 +1,63 @@
+#ifndef CHUNK_STORE_H
+#define CHUNK_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Variable-size chunk records in one memory-mapped file.
+//
+// The file starts with a header and one slot per chunk giving where its bytes
+// live; records follow in 4 KB-aligned blocks. A record is rewritten in place
+// while it fits its block and moves to the end of the file when it grows, so
+// the file only ever grows until Reset. It is scratch space for paged-out
+// chunks: created in the temp directory on the first Write and unlinked at
+// once, so it goes away with the process.
+class ChunkStore {
+public:
+    ChunkStore();
+    ~ChunkStore();
+
+    ChunkStore(const ChunkStore&) = delete;
+    ChunkStore& operator=(const ChunkStore&) = delete;
+
+    // Forgets every record and sizes the slot table for chunkCount chunks
+    void Reset(size_t chunkCount);
+
+    // Returns false, keeping the old record, when the file cannot grow
+    bool Write(size_t chunk, const void* data, size_t size);
+
+    // Stored bytes of a chunk, nullptr if it was never written. Valid until
+    // the next Write or Reset; reads from several threads are safe between writes.
+    const uint8_t* Read(size_t chunk, size_t& size) const;
+
+    size_t GetFileSize() const { return mappedSize; }
+
+private:
+    struct Header {
+        char magic[8];
+        uint64_t chunkCount;
+        uint64_t dataEnd;  // First free byte
+    };
+    struct Slot {
+        uint64_t offset;   // 0 when the chunk has no record
+        uint32_t size;
+        uint32_t capacity;
+    };
+
+    static constexpr size_t BLOCK_SIZE = 4096;
+    static constexpr size_t MIN_FILE_SIZE = 1 << 20;
+
+    bool Open();
+    bool Grow(size_t minimumSize);
+    void Close();
+    Header* GetHeader() const { return reinterpret_cast<Header*>(mapping); }
+    Slot* GetSlots() const { return reinterpret_cast<Slot*>(mapping + sizeof(Header)); }
+    size_t GetTableSize() const;
+
+    size_t chunkCount;
+    int fd;
+    uint8_t* mapping;
+    size_t mappedSize;
+};
+
+#endif // CHUNK_STORE_H
@@ -0,0 +1,83 @@
+#include "deposit_map.h"
+#include <algorithm>
+
+void DepositMap::Resize(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    tilesX = (width + TILE_MASK) >> TILE_SHIFT;
+    tilesY = (height + TILE_MASK) >> TILE_SHIFT;
+    tiles.clear();
+    tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+    count = 0;
+}
+
+const Deposit* DepositMap::LowerBound(const Tile& tile, uint16_t cell, ResourceId id) {
+    return std::lower_bound(tile.data(), tile.data() + tile.size(), Deposit{cell, id, 0.0f},
+                            [](const Deposit& a, const Deposit& b) {
+        return a.cell != b.cell ? a.cell < b.cell : a.id < b.id;
+    });
+}
+
+void DepositMap::Set(int x, int y, ResourceId id, float amount) {
+    Tile& tile = tiles[TileIndex(x, y)];
+    uint16_t cell = CellIndex(x, y);
+    size_t position = LowerBound(tile, cell, id) - tile.data();
+    bool found = position < tile.size() && tile[position].cell == cell && tile[position].id == id;
+
+    if (amount <= 0.0f) {
+        if (found) {
+            tile.erase(tile.begin() + position);
+            count--;
+        }
+        return;
+    }
+
+    if (found) {
+        tile[position].amount = amount;
+    } else {
+        // Cells written in order, as map generation does, always append
+        tile.insert(tile.begin() + position, Deposit{cell, id, amount});
+        count++;
+    }
+}
+
+float DepositMap::Get(int x, int y, ResourceId id) const {
+    const Tile& tile = tiles[TileIndex(x, y)];
+    uint16_t cell = CellIndex(x, y);
+    const Deposit* deposit = LowerBound(tile, cell, id);
+    if (deposit != tile.data() + tile.size() && deposit->cell == cell && deposit->id == id) {
+        return deposit->amount;
+    }
+    return 0.0f;
+}
+
+DepositSpan DepositMap::GetCell(int x, int y) const {
+    const Tile& tile = tiles[TileIndex(x, y)];
+    uint16_t cell = CellIndex(x, y);
+    const Deposit* first = LowerBound(tile, cell, 0);
+    const Deposit* last = first;
+    const Deposit* end = tile.data() + tile.size();
+    while (last != end && last->cell == cell) {
+        ++last;
+    }
+    return {first, last};
+}
+
+void DepositMap::ReplaceTile(int tileX, int tileY, std::vector<Deposit>& records) {
+    tiles[static_cast<size_t>(tileY) * tilesX + tileX].swap(records);
+}
+
+void DepositMap::Recount() {
+    count = 0;
+    for (const auto& tile : tiles) {
+        count += tile.size();
+    }
+}
+
+size_t DepositMap::GetMemoryUsage() const {
+    size_t bytes = tiles.size() * sizeof(Tile);
+    for (const auto& tile : tiles) {
+        bytes += tile.capacity() * sizeof(Deposit);
+    }
+    return bytes;
+}
@@ -0,0 +1,120 @@
+#ifndef DEPOSIT_MAP_H
+#define DEPOSIT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "resource.h"
+
+// One resource deposit in one grid cell, 8 bytes
+struct Deposit {
+    uint16_t cell;       // Cell index within its tile
+    ResourceId id;
+    float amount;
+};
+
+// Non-owning view of consecutive deposits, valid until the map changes
+struct DepositSpan {
+    const Deposit* first;
+    const Deposit* last;
+
+    const Deposit* begin() const { return first; }
+    const Deposit* end() const { return last; }
+    size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+};
+
+// Resource deposits of every planet cell, packed as records.
+//
+// The surface is split into 64x64-cell tiles like TiledGrid. Each tile keeps
+// its deposits in one array sorted by cell and resource, so a cell's deposits
+// are one contiguous run and a row of cells within a tile is one run too. Empty
+// tiles cost an empty vector; lookups and rectangle walks never allocate.
+class DepositMap {
+public:
+    static constexpr int TILE_SHIFT = 6;
+    static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+    static constexpr int TILE_MASK = TILE_SIZE - 1;
+
+    DepositMap() : width(0), height(0), tilesX(0), tilesY(0), count(0) {}
+
+    void Resize(int newWidth, int newHeight);  // Drops every deposit
+
+    // Coordinates must be on the map. An amount of zero or less removes the deposit.
+    void Set(int x, int y, ResourceId id, float amount);
+    float Get(int x, int y, ResourceId id) const;
+    DepositSpan GetCell(int x, int y) const;
+
+    // Calls fn(x, y, const Deposit&) for every deposit in the inclusive cell rectangle,
+    // clipped to the map, row by row within each tile
+    template<typename Fn>
+    void ForEachInRect(int minX, int minY, int maxX, int maxY, Fn&& fn) const;
+
+    // Swaps in a tile's deposits, sorted by cell and resource, and hands back the
+    // old ones. Different tiles may be replaced from different threads; the
+    // deposit count is stale until Recount runs.
+    void ReplaceTile(int tileX, int tileY, std::vector<Deposit>& records);
+    void Recount();
+    int GetTilesX() const { return tilesX; }
+    int GetTilesY() const { return tilesY; }
+
+    size_t GetDepositCount() const { return count; }
+    size_t GetMemoryUsage() const;
+
+private:
+    typedef std::vector<Deposit> Tile;
+
+    size_t TileIndex(int x, int y) const {
+        return static_cast<size_t>(y >> TILE_SHIFT) * tilesX + (x >> TILE_SHIFT);
+    }
+    static uint16_t CellIndex(int x, int y) {
+        return static_cast<uint16_t>(((y & TILE_MASK) << TILE_SHIFT) | (x & TILE_MASK));
+    }
+    static const Deposit* LowerBound(const Tile& tile, uint16_t cell, ResourceId id);
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    size_t count;
+    std::vector<Tile> tiles;  // Row-major tile table
+};
+
+template<typename Fn>
+void DepositMap::ForEachInRect(int minX, int minY, int maxX, int maxY, Fn&& fn) const {
+    minX = minX < 0 ? 0 : minX;
+    minY = minY < 0 ? 0 : minY;
+    maxX = maxX >= width ? width - 1 : maxX;
+    maxY = maxY >= height ? height - 1 : maxY;
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    for (int tileY = minY >> TILE_SHIFT; tileY <= maxY >> TILE_SHIFT; tileY++) {
+        for (int tileX = minX >> TILE_SHIFT; tileX <= maxX >> TILE_SHIFT; tileX++) {
+            const Tile& tile = tiles[static_cast<size_t>(tileY) * tilesX + tileX];
+            if (tile.empty()) {
+                continue;
+            }
+
+            // The rectangle's part of this tile, in tile-local cells
+            int originX = tileX << TILE_SHIFT;
+            int originY = tileY << TILE_SHIFT;
+            int left = (minX > originX ? minX : originX) - originX;
+            int right = (maxX < originX + TILE_MASK ? maxX : originX + TILE_MASK) - originX;
+            int top = (minY > originY ? minY : originY) - originY;
+            int bottom = (maxY < originY + TILE_MASK ? maxY : originY + TILE_MASK) - originY;
+
+            const Deposit* end = tile.data() + tile.size();
+            for (int row = top; row <= bottom; row++) {
+                uint16_t rowEnd = static_cast<uint16_t>((row << TILE_SHIFT) | right);
+                for (const Deposit* deposit = LowerBound(tile, static_cast<uint16_t>((row << TILE_SHIFT) | left), 0);
+                     deposit != end && deposit->cell <= rowEnd; ++deposit) {
+                    fn(originX + (deposit->cell & TILE_MASK), originY + (deposit->cell >> TILE_SHIFT), *deposit);
+                }
+            }
+        }
+    }
+}
+
+#endif // DEPOSIT_MAP_H
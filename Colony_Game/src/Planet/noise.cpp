@@ -0,0 +1,78 @@
+#include "noise.h"
+
+// Integer hash with good avalanche, cheap enough to run per lattice corner
+static inline uint32_t Hash(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Quintic smoothstep, continuous second derivative at the lattice
+static inline float Fade(float t) {
+    return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+// Dot product with one of four diagonal gradients picked by the hash. The signs
+// are arithmetic so that unvectorized builds do not branch on random bits.
+static inline float Gradient(uint32_t hash, float dx, float dy) {
+    float signX = static_cast<float>(static_cast<int>(hash & 1u) * 2 - 1);
+    float signY = static_cast<float>(static_cast<int>(hash & 2u) - 1);
+    return signX * dx + signY * dy;
+}
+
+uint32_t Noise::DeriveSeed(uint32_t seed, uint32_t salt) {
+    return Hash(seed ^ Hash(salt + 0x9E3779B9u));
+}
+
+void Noise::AddGradientRow(uint32_t seed, float frequency, float amplitude, int x0, int y, float* out) {
+    // The row's lattice line and its weight are shared by every cell
+    float fy = y * frequency;
+    int yi = static_cast<int>(fy);  // Truncation is floor for non-negative coordinates
+    float dy = fy - yi;
+    float v = Fade(dy);
+    uint32_t row0 = Hash(seed ^ (static_cast<uint32_t>(yi) * 0x85EBCA6Bu));
+    uint32_t row1 = Hash(seed ^ (static_cast<uint32_t>(yi + 1) * 0x85EBCA6Bu));
+
+    for (int i = 0; i < ROW_CELLS; i++) {
+        float fx = (x0 + i) * frequency;
+        int xi = static_cast<int>(fx);
+        float dx = fx - xi;
+        float u = Fade(dx);
+
+        uint32_t column0 = static_cast<uint32_t>(xi) * 0xC2B2AE35u;
+        uint32_t column1 = static_cast<uint32_t>(xi + 1) * 0xC2B2AE35u;
+        float n00 = Gradient(Hash(row0 ^ column0), dx, dy);
+        float n10 = Gradient(Hash(row0 ^ column1), dx - 1.0f, dy);
+        float n01 = Gradient(Hash(row1 ^ column0), dx, dy - 1.0f);
+        float n11 = Gradient(Hash(row1 ^ column1), dx - 1.0f, dy - 1.0f);
+
+        float top = n00 + u * (n10 - n00);
+        float bottom = n01 + u * (n11 - n01);
+        out[i] += amplitude * (top + v * (bottom - top));
+    }
+}
+
+void Noise::FractalRow(uint32_t seed, float frequency, int octaves, int x0, int y, float* out) {
+    for (int i = 0; i < ROW_CELLS; i++) {
+        out[i] = 0.0f;
+    }
+
+    float amplitude = 1.0f;
+    float total = 0.0f;
+    for (int octave = 0; octave < octaves; octave++) {
+        AddGradientRow(DeriveSeed(seed, octave), frequency, amplitude, x0, y, out);
+        total += amplitude;
+        frequency *= 2.0f;
+        amplitude *= 0.5f;
+    }
+
+    // Sums of several layers rarely leave half their range, stretch that to [0, 1]
+    float scale = 1.0f / total;
+    for (int i = 0; i < ROW_CELLS; i++) {
+        float value = 0.5f + out[i] * scale;
+        out[i] = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef NOISE_H
+#define NOISE_H
+
+#include <cstdint>
+
+// Seeded 2D gradient noise, evaluated a row of cells at a time.
+//
+// Every value depends only on the seed and the cell coordinates, so any split
+// of a map into rows or chunks, on any number of threads, gives the same
+// bits. Rows have a fixed width and their loops are straight-line integer and
+// float code with no branches or calls, which the compiler turns into SIMD.
+namespace Noise {
+    const int ROW_CELLS = 64;  // Cells per row call, one planet tile across
+
+    // Mixes a seed with a salt into an independent seed, e.g. one per map layer
+    uint32_t DeriveSeed(uint32_t seed, uint32_t salt);
+
+    // out[i] += amplitude * noise((x0 + i) * frequency, y * frequency) for i < ROW_CELLS.
+    // Noise is roughly in [-1, 1]; coordinates must not be negative.
+    void AddGradientRow(uint32_t seed, float frequency, float amplitude, int x0, int y, float* out);
+
+    // Fractal sum of `octaves` gradient layers, each twice the frequency and half
+    // the amplitude of the previous, normalized to [0, 1] and written to out
+    void FractalRow(uint32_t seed, float frequency, int octaves, int x0, int y, float* out);
+}
+
+#endif // NOISE_H
@@ -1,9 +1,49 @@
 #include "planet.h"
-#include <iostream>
+#include "log.h"
+#include "profiler.h"
+#include "job_system.h"
+#include "noise.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
 
-Planet::Planet() : size(20, 20), time(0) {
-    // Initialize the map with empty tiles
-    map.resize(size.first, std::vector<int>(size.second, 0));
+// Map generation. Continents and climate scale with the planet so every size
+// gets a few of each; ore pockets have a fixed size in cells.
+static constexpr float CONTINENTS_PER_SIDE = 3.0f;
+static constexpr float CLIMATE_ZONES_PER_SIDE = 5.0f;
+static constexpr float ORE_FREQUENCY = 1.0f / 24.0f;
+static constexpr int ELEVATION_OCTAVES = 6;
+static constexpr int MOISTURE_OCTAVES = 3;
+static constexpr int ORE_OCTAVES = 3;
+static constexpr float SEA_LEVEL = 0.48f;
+static constexpr float SHELF_LEVEL = 0.44f;    // Shallow water above this holds water deposits
+static constexpr float HILLS_LEVEL = 0.65f;
+static constexpr float MOUNTAIN_LEVEL = 0.74f;
+static constexpr float DRY_LEVEL = 0.42f;
+static constexpr float WET_LEVEL = 0.56f;
+static constexpr float IRON_ORE = 0.6f;        // Ore noise above which land holds iron
+static constexpr float RARE_METAL_ORE = 0.66f; // ... and hills or mountains rare metal
+static constexpr float FUEL_ORE = 0.38f;       // Ore noise below which desert holds fuel
+static constexpr float MAX_DEPOSIT = 1000.0f;
+
+static_assert(TiledGrid<uint8_t>::TILE_SIZE == DepositMap::TILE_SIZE && DepositMap::TILE_SIZE == Noise::ROW_CELLS,
+              "Map generation fills terrain and deposits one shared tile at a time");
+
+Planet::Planet(const PlanetConfig& config) : mapGenerated(false), streamPass(0), time(0) {
+    Configure(config);
+}
+
+void Planet::Configure(const PlanetConfig& newConfig) {
+    config = newConfig.Clamped();
+
+    // Tiles are allocated as cells are written, so even the largest planet starts small
+    ResetChunks();
+    mapGenerated = false;
+
+    // The empty-planet area sits at the centre, which moved
+    activeArea.reset();
+    LOG_INFO("Planet surface: %dx%d cells of %.0f units", config.width, config.height, config.cellSize);
 }
 
 Planet::~Planet() {
@@ -13,73 +53,478 @@ Planet::~Planet() {
 }
 
 void Planet::GenerateMap() {
-    std::cout << "Generating planet map..." << std::endl;
-    // TODO: Implement map generation algorithm
+    PROFILE_SCOPE("Planet::GenerateMap");
+
+    // Stored chunks and edits belong to the previous map
+    ResetChunks();
+    mapGenerated = true;
+
+    if (GetChunkCount() <= static_cast<size_t>(config.residentChunks)) {
+        wantedChunks.clear();
+        for (uint32_t chunk = 0; chunk < GetChunkCount(); chunk++) {
+            wantedChunks.push_back(chunk);
+        }
+        PageInChunks(wantedChunks);
+    }
+
+    LOG_INFO("Generated planet map from seed %u: %zu of %zu chunks resident, %zu deposits",
+             config.seed, GetResidentChunkCount(), GetChunkCount(), deposits.GetDepositCount());
+}
+
+void Planet::GenerateTile(int tileX, int tileY, std::vector<Deposit>& records) {
+    const int tileShift = TiledGrid<uint8_t>::TILE_SHIFT;
+    const int tileSize = TiledGrid<uint8_t>::TILE_SIZE;
+    int originX = tileX << tileShift;
+    int originY = tileY << tileShift;
+    int columns = std::min(tileSize, config.width - originX);
+    int rows = std::min(tileSize, config.height - originY);
+
+    float side = static_cast<float>(std::max(config.width, config.height));
+    uint32_t elevationSeed = Noise::DeriveSeed(config.seed, 1);
+    uint32_t moistureSeed = Noise::DeriveSeed(config.seed, 2);
+    uint32_t oreSeed = Noise::DeriveSeed(config.seed, 3);
+
+    uint8_t* cells = terrain.AllocateTile(tileX, tileY);
+    records.clear();
+
+    // One row of each layer at a time, then classify the row. Rows are always a
+    // full tile wide; cells past the planet edge are computed and dropped.
+    float elevation[Noise::ROW_CELLS];
+    float moisture[Noise::ROW_CELLS];
+    float ore[Noise::ROW_CELLS];
+    for (int row = 0; row < rows; row++) {
+        int y = originY + row;
+        Noise::FractalRow(elevationSeed, CONTINENTS_PER_SIDE / side, ELEVATION_OCTAVES, originX, y, elevation);
+        Noise::FractalRow(moistureSeed, CLIMATE_ZONES_PER_SIDE / side, MOISTURE_OCTAVES, originX, y, moisture);
+        Noise::FractalRow(oreSeed, ORE_FREQUENCY, ORE_OCTAVES, originX, y, ore);
+
+        for (int column = 0; column < columns; column++) {
+            uint8_t type;
+            if (elevation[column] < SEA_LEVEL) {
+                type = Terrain::Ocean;
+            } else if (elevation[column] >= MOUNTAIN_LEVEL) {
+                type = Terrain::Mountains;
+            } else if (elevation[column] >= HILLS_LEVEL) {
+                type = Terrain::Hills;
+            } else if (moisture[column] < DRY_LEVEL) {
+                type = Terrain::Desert;
+            } else if (moisture[column] >= WET_LEVEL) {
+                type = Terrain::Forest;
+            } else {
+                type = Terrain::Plains;
+            }
+            uint16_t cell = static_cast<uint16_t>((row << tileShift) | column);
+            cells[cell] = type;
+
+            // Cells and, within a cell, resource ids ascend, so records come out sorted
+            if (type != Terrain::Ocean && ore[column] > IRON_ORE) {
+                float amount = MAX_DEPOSIT * (ore[column] - IRON_ORE) / (1.0f - IRON_ORE);
+                records.push_back(Deposit{cell, Resource::Iron, amount});
+            }
+            if (type == Terrain::Ocean && elevation[column] > SHELF_LEVEL) {
+                float amount = MAX_DEPOSIT * (SEA_LEVEL - elevation[column]) / (SEA_LEVEL - SHELF_LEVEL);
+                records.push_back(Deposit{cell, Resource::Water, amount});
+            }
+            if (type == Terrain::Desert && ore[column] < FUEL_ORE) {
+                float amount = MAX_DEPOSIT * (FUEL_ORE - ore[column]) / FUEL_ORE;
+                records.push_back(Deposit{cell, Resource::Fuel, amount});
+            }
+            if ((type == Terrain::Hills || type == Terrain::Mountains) && ore[column] > RARE_METAL_ORE) {
+                float amount = MAX_DEPOSIT * (ore[column] - RARE_METAL_ORE) / (1.0f - RARE_METAL_ORE);
+                records.push_back(Deposit{cell, Resource::RareMetal, amount});
+            }
+        }
+    }
+}
+
+uint8_t Planet::GetTerrain(std::pair<int, int> location) {
+    if (!config.Contains(location.first, location.second)) {
+        return Terrain::Ocean;
+    }
+    EnsureResident(location.first, location.second, location.first, location.second);
+    return terrain.Get(location.first, location.second);
+}
+
+void Planet::ResetChunks() {
+    terrain.Resize(config.width, config.height);
+    deposits.Resize(config.width, config.height);
+    size_t chunkCount = static_cast<size_t>(terrain.GetTilesX()) * terrain.GetTilesY();
+    residentChunks.Reset(chunkCount);
+    chunkDirty.assign(chunkCount, 0);
+    chunkWantedPass.assign(chunkCount, 0);
+    streamPass = 0;
+    chunkStore.Reset(chunkCount);
+}
+
+void Planet::PageIn(uint32_t chunk, std::vector<Deposit>& records) {
+    const size_t tileCells = TiledGrid<uint8_t>::TILE_CELLS;
+    int tileX = static_cast<int>(chunk % terrain.GetTilesX());
+    int tileY = static_cast<int>(chunk / terrain.GetTilesX());
+
+    // An edited chunk comes back from the store, any other is regenerated
+    size_t size = 0;
+    const uint8_t* stored = chunkStore.Read(chunk, size);
+    if (stored) {
+        std::memcpy(terrain.AllocateTile(tileX, tileY), stored, tileCells);
+        records.resize((size - tileCells) / sizeof(Deposit));
+        if (!records.empty()) {
+            std::memcpy(records.data(), stored + tileCells, records.size() * sizeof(Deposit));
+        }
+        deposits.ReplaceTile(tileX, tileY, records);
+    } else if (mapGenerated) {
+        GenerateTile(tileX, tileY, records);
+        deposits.ReplaceTile(tileX, tileY, records);
+    }
+    // Otherwise the chunk is blank: no terrain tile and no deposits until written
+}
+
+void Planet::PageInChunks(const std::vector<uint32_t>& chunks) {
+    // Chunks share nothing, and store reads are safe while nothing is written
+    JobSystem::Global().ParallelFor(chunks.size(), 1, [this, &chunks](size_t begin, size_t end) {
+        std::vector<Deposit> records;
+        for (size_t i = begin; i < end; i++) {
+            PageIn(chunks[i], records);
+        }
+    });
+    for (uint32_t chunk : chunks) {
+        residentChunks.Touch(chunk);
+    }
+    deposits.Recount();
+}
+
+bool Planet::PageOut(uint32_t chunk) {
+    const size_t tileCells = TiledGrid<uint8_t>::TILE_CELLS;
+    int tileX = static_cast<int>(chunk % terrain.GetTilesX());
+    int tileY = static_cast<int>(chunk / terrain.GetTilesX());
+
+    // Swapping in a fresh vector frees the tile's deposits along with `records`
+    std::vector<Deposit> records;
+    deposits.ReplaceTile(tileX, tileY, records);
+
+    if (chunkDirty[chunk]) {
+        chunkBuffer.resize(tileCells + records.size() * sizeof(Deposit));
+        const uint8_t* cells = terrain.GetTile(tileX, tileY);
+        if (cells) {
+            std::memcpy(chunkBuffer.data(), cells, tileCells);
+        } else {
+            std::memset(chunkBuffer.data(), 0, tileCells);
+        }
+        if (!records.empty()) {
+            std::memcpy(chunkBuffer.data() + tileCells, records.data(), records.size() * sizeof(Deposit));
+        }
+
+        if (!chunkStore.Write(chunk, chunkBuffer.data(), chunkBuffer.size())) {
+            deposits.ReplaceTile(tileX, tileY, records);  // Stays resident rather than losing edits
+            return false;
+        }
+        chunkDirty[chunk] = 0;
+    }
+
+    terrain.ReleaseTile(tileX, tileY);
+    residentChunks.Remove(chunk);
+    return true;
+}
+
+void Planet::EnsureResident(int minX, int minY, int maxX, int maxY) {
+    minX = std::max(minX, 0) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    minY = std::max(minY, 0) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    maxX = std::min(maxX, config.width - 1) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    maxY = std::min(maxY, config.height - 1) >> TiledGrid<uint8_t>::TILE_SHIFT;
+
+    chunksToLoad.clear();
+    for (int chunkY = minY; chunkY <= maxY; chunkY++) {
+        for (int chunkX = minX; chunkX <= maxX; chunkX++) {
+            uint32_t chunk = static_cast<uint32_t>(chunkY * terrain.GetTilesX() + chunkX);
+            if (!residentChunks.Contains(chunk)) {
+                chunksToLoad.push_back(chunk);
+            }
+        }
+    }
+    if (!chunksToLoad.empty()) {
+        PageInChunks(chunksToLoad);
+    }
+}
+
+void Planet::WantChunks(int minX, int minY, int maxX, int maxY, size_t limit) {
+    // Chunk rectangle of the cell rectangle, clipped to the planet
+    minX = std::max(minX, 0) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    minY = std::max(minY, 0) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    maxX = std::min(maxX, config.width - 1) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    maxY = std::min(maxY, config.height - 1) >> TiledGrid<uint8_t>::TILE_SHIFT;
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    // More than the limit: the square of chunks around the centre
+    if (static_cast<size_t>(maxX - minX + 1) * (maxY - minY + 1) > limit) {
+        int side = std::max(1, static_cast<int>(std::sqrt(static_cast<float>(limit))));
+        int centerX = (minX + maxX) / 2;
+        int centerY = (minY + maxY) / 2;
+        minX = std::max(minX, centerX - side / 2);
+        minY = std::max(minY, centerY - side / 2);
+        maxX = std::min(maxX, minX + side - 1);
+        maxY = std::min(maxY, minY + side - 1);
+    }
+
+    size_t budget = static_cast<size_t>(config.residentChunks);
+    for (int chunkY = minY; chunkY <= maxY; chunkY++) {
+        for (int chunkX = minX; chunkX <= maxX && wantedChunks.size() < budget; chunkX++) {
+            uint32_t chunk = static_cast<uint32_t>(chunkY * terrain.GetTilesX() + chunkX);
+            if (chunkWantedPass[chunk] != streamPass) {
+                chunkWantedPass[chunk] = streamPass;
+                wantedChunks.push_back(chunk);
+            }
+        }
+    }
+}
+
+void Planet::StreamChunks(Rectangle view) {
+    PROFILE_SCOPE("Planet::StreamChunks");
+
+    size_t budget = static_cast<size_t>(config.residentChunks);
+    streamPass++;
+    wantedChunks.clear();
+
+    // The view first, at most half the budget so a zoomed-out camera leaves room for
+    // the colonies, then every colony's footprint, both with a chunk of margin
+    const int margin = TiledGrid<uint8_t>::TILE_SIZE;
+    if (view.width > 0.0f && view.height > 0.0f) {
+        Vector2 min = WorldToGrid({view.x, view.y});
+        Vector2 max = WorldToGrid({view.x + view.width, view.y + view.height});
+        WantChunks(static_cast<int>(min.x) - margin, static_cast<int>(min.y) - margin,
+                   static_cast<int>(max.x) + margin, static_cast<int>(max.y) + margin, std::max<size_t>(budget / 2, 1));
+    }
+    for (const ActiveArea& footprint : colonyFootprints) {
+        if (footprint.radius < 0.0f) {
+            continue;
+        }
+        Vector2 min = WorldToGrid({footprint.centroid.x - footprint.radius, footprint.centroid.y - footprint.radius});
+        Vector2 max = WorldToGrid({footprint.centroid.x + footprint.radius, footprint.centroid.y + footprint.radius});
+        WantChunks(static_cast<int>(min.x) - margin, static_cast<int>(min.y) - margin,
+                   static_cast<int>(max.x) + margin, static_cast<int>(max.y) + margin, budget);
+    }
+
+    // Wanted chunks in memory become the most recent, the rest are loaded below
+    chunksToLoad.clear();
+    for (uint32_t chunk : wantedChunks) {
+        if (residentChunks.Contains(chunk)) {
+            residentChunks.Touch(chunk);
+        } else {
+            chunksToLoad.push_back(chunk);
+        }
+    }
+
+    // Make room from the cold end. Every store write happens here, before the parallel reads.
+    size_t pagedOut = 0;
+    while (residentChunks.Size() + chunksToLoad.size() > budget) {
+        uint32_t coldest = residentChunks.GetLeastRecent();
+        if (coldest == LruList::NONE || chunkWantedPass[coldest] == streamPass || !PageOut(coldest)) {
+            break;
+        }
+        pagedOut++;
+    }
+
+    if (!chunksToLoad.empty()) {
+        PageInChunks(chunksToLoad);
+    } else if (pagedOut > 0) {
+        deposits.Recount();
+    }
+    if (pagedOut > 0 || !chunksToLoad.empty()) {
+        LOG_DEBUG("Planet streamed %zu chunks in and %zu out, %zu resident", chunksToLoad.size(), pagedOut,
+                  GetResidentChunkCount());
+    }
 }
 
 void Planet::AddColony(Colony* colony) {
     colonies.push_back(colony);
-    std::cout << "New colony added to the planet." << std::endl;
+    LOG_INFO("New colony added to the planet.");
+}
+
+DepositSpan Planet::GetResourceInfo(std::pair<int, int> location) {
+    if (!config.Contains(location.first, location.second)) {
+        return {nullptr, nullptr}; // No resources outside the planet
+    }
+    EnsureResident(location.first, location.second, location.first, location.second);
+    return deposits.GetCell(location.first, location.second);
 }
 
-std::vector<std::string> Planet::GetResourceInfo(std::pair<int, int> location) const {
-    auto it = resources.find(location);
-    if (it != resources.end()) {
-        return it->second;
+float Planet::GetResourceDeposit(std::pair<int, int> location, ResourceId id) {
+    if (!config.Contains(location.first, location.second)) {
+        return 0.0f;
     }
-    return std::vector<std::string>(); // Return empty vector if no resources found
+    EnsureResident(location.first, location.second, location.first, location.second);
+    return deposits.Get(location.first, location.second, id);
+}
+
+void Planet::SetResourceDeposit(std::pair<int, int> location, ResourceId id, float amount) {
+    if (!config.Contains(location.first, location.second)) {
+        return;
+    }
+    EnsureResident(location.first, location.second, location.first, location.second);
+    deposits.Set(location.first, location.second, id, amount);
+    chunkDirty[static_cast<size_t>(location.second >> DepositMap::TILE_SHIFT) * deposits.GetTilesX() +
+               (location.first >> DepositMap::TILE_SHIFT)] = 1;
 }
 
 void Planet::Update() {
+    PROFILE_SCOPE("Planet::Update");
+
     time++;
     // TODO: Implement update logic (e.g., trigger events, update colonies)
-    std::cout << "Planet updated. Current time: " << time << std::endl;
+    LOG_DEBUG("Planet updated. Current time: %d", time);
 }
 
-Planet::ActiveArea Planet::CalculateActiveArea(const std::vector<Colony*>& colonies) const {
-    ActiveArea area = {{0, 0}, 0};
+// Minimum enclosing circle of disks, Welzl's algorithm in its iterative form.
+// Every step only needs the circle through one, two or three disks that lie on
+// its boundary. Expected linear time once the input order is shuffled.
+typedef Planet::ActiveArea Circle;
 
-    // If no colonies, return center of planet
-    if (colonies.empty()) {
-        area.centroid = {
-            PLANET_WIDTH / 2,
-            PLANET_HEIGHT / 2
-        };
-        area.radius = 0;
-        return area;
+static bool Encloses(const Circle& outer, const Circle& inner) {
+    float slack = outer.radius * 1e-5f + 1e-3f;  // Rounding of the constructions below
+    return Vector2Distance(outer.centroid, inner.centroid) + inner.radius <= outer.radius + slack;
+}
+
+static Circle CircleFromTwo(const Circle& a, const Circle& b) {
+    if (Encloses(a, b)) return a;
+    if (Encloses(b, a)) return b;
+
+    // Centre on the line between the disks, touching both far sides
+    float distance = Vector2Distance(a.centroid, b.centroid);
+    float radius = (distance + a.radius + b.radius) * 0.5f;
+    Vector2 direction = Vector2Scale(Vector2Subtract(b.centroid, a.centroid), 1.0f / distance);
+    return {Vector2Add(a.centroid, Vector2Scale(direction, radius - a.radius)), radius};
+}
+
+static Circle CircleFromThree(const Circle& a, const Circle& b, const Circle& c) {
+    // One of the two-disk circles may already hold the third disk
+    Circle best = {{0, 0}, -1.0f};
+    const Circle pairs[3] = {CircleFromTwo(a, b), CircleFromTwo(a, c), CircleFromTwo(b, c)};
+    const Circle* others[3] = {&c, &b, &a};
+    for (int i = 0; i < 3; i++) {
+        if (Encloses(pairs[i], *others[i]) && (best.radius < 0 || pairs[i].radius < best.radius)) {
+            best = pairs[i];
+        }
+    }
+    if (best.radius >= 0) {
+        return best;
+    }
+
+    // Otherwise solve for the circle internally tangent to all three:
+    // |p - c_i| = r - r_i. Differences of the squared equations are linear in
+    // x, y and r, which leaves a quadratic in r.
+    double x1 = a.centroid.x, y1 = a.centroid.y, r1 = a.radius;
+    double k1 = x1 * x1 + y1 * y1 - r1 * r1;
+    const Circle* rest[2] = {&b, &c};
+    double coef[2][4];  // a x + b y = d + c r
+    for (int j = 0; j < 2; j++) {
+        double xj = rest[j]->centroid.x, yj = rest[j]->centroid.y, rj = rest[j]->radius;
+        coef[j][0] = 2.0 * (xj - x1);
+        coef[j][1] = 2.0 * (yj - y1);
+        coef[j][2] = 2.0 * (rj - r1);
+        coef[j][3] = (xj * xj + yj * yj - rj * rj) - k1;
     }
 
-    // Calculate centroid
-    float sumX = 0, sumY = 0;
-    int count = 0;
+    double det = coef[0][0] * coef[1][1] - coef[1][0] * coef[0][1];
+    if (std::fabs(det) > 1e-12) {
+        // x = x0 + xr * r, y = y0 + yr * r
+        double x0 = (coef[0][3] * coef[1][1] - coef[1][3] * coef[0][1]) / det;
+        double xr = (coef[0][2] * coef[1][1] - coef[1][2] * coef[0][1]) / det;
+        double y0 = (coef[0][0] * coef[1][3] - coef[1][0] * coef[0][3]) / det;
+        double yr = (coef[0][0] * coef[1][2] - coef[1][0] * coef[0][2]) / det;
 
-    for (const auto& colony : colonies) {
-        Vector2 colonyCentroid = colony->GetCentroid();
-        sumX += colonyCentroid.x;
-        sumY += colonyCentroid.y;
-        count++;
+        double u = x0 - x1, v = y0 - y1;
+        double qa = xr * xr + yr * yr - 1.0;
+        double qb = 2.0 * (u * xr + v * yr + r1);
+        double qc = u * u + v * v - r1 * r1;
+
+        double minRadius = std::max(r1, std::max(static_cast<double>(b.radius), static_cast<double>(c.radius)));
+        double roots[2];
+        int rootCount = 0;
+        if (std::fabs(qa) < 1e-12) {
+            if (std::fabs(qb) > 1e-12) roots[rootCount++] = -qc / qb;
+        } else {
+            double discriminant = qb * qb - 4.0 * qa * qc;
+            if (discriminant >= 0) {
+                double root = std::sqrt(discriminant);
+                roots[rootCount++] = (-qb - root) / (2.0 * qa);
+                roots[rootCount++] = (-qb + root) / (2.0 * qa);
+            }
+        }
+
+        for (int i = 0; i < rootCount; i++) {
+            double r = roots[i];
+            if (r < minRadius) continue;
+            Circle candidate = {{static_cast<float>(x0 + xr * r), static_cast<float>(y0 + yr * r)}, static_cast<float>(r)};
+            if (Encloses(candidate, a) && Encloses(candidate, b) && Encloses(candidate, c) &&
+                (best.radius < 0 || candidate.radius < best.radius)) {
+                best = candidate;
+            }
+        }
+        if (best.radius >= 0) {
+            return best;
+        }
     }
 
-    area.centroid.x = sumX / count;
-    area.centroid.y = sumY / count;
+    // Collinear centres or rounding trouble: grow the widest pair to take the third
+    Circle fallback = pairs[0];
+    for (const auto& pair : pairs) {
+        if (pair.radius > fallback.radius) fallback = pair;
+    }
+    for (const Circle* disk : {&a, &b, &c}) {
+        fallback.radius = std::max(fallback.radius,
+                                   Vector2Distance(fallback.centroid, disk->centroid) + disk->radius);
+    }
+    return fallback;
+}
 
-    // Calculate radius (distance to furthest colony)
-    area.radius = 0;
-    for (const auto& colony : colonies) {
-        Vector2 colonyCentroid = colony->GetCentroid();
-        float distance = Vector2Distance(area.centroid, colonyCentroid);
-        area.radius = std::max(area.radius, distance);
+// Smallest circle holding disks[0..count) with `p` (and `q`) on its boundary
+static Circle EncloseWithTwo(const std::vector<Circle>& disks, size_t count, const Circle& p, const Circle& q) {
+    Circle circle = CircleFromTwo(p, q);
+    for (size_t i = 0; i < count; i++) {
+        if (!Encloses(circle, disks[i])) {
+            circle = CircleFromThree(p, q, disks[i]);
+        }
     }
+    return circle;
+}
 
-    // Add some padding to the radius
-    area.radius *= 1.2f;  // 20% padding
+static Circle EncloseWithOne(const std::vector<Circle>& disks, size_t count, const Circle& p) {
+    Circle circle = p;
+    for (size_t i = 0; i < count; i++) {
+        if (!Encloses(circle, disks[i])) {
+            circle = EncloseWithTwo(disks, i, p, disks[i]);
+        }
+    }
+    return circle;
+}
 
-    return area;
+static Circle Enclose(const std::vector<Circle>& disks) {
+    Circle circle = {{0, 0}, -1.0f};
+    for (size_t i = 0; i < disks.size(); i++) {
+        if (circle.radius < 0 || !Encloses(circle, disks[i])) {
+            circle = EncloseWithOne(disks, i, disks[i]);
+        }
+    }
+    return circle;
+}
+
+Planet::ActiveArea Planet::CalculateActiveArea(const std::vector<ActiveArea>& footprints) const {
+    // If no colonies, return center of planet
+    if (footprints.empty()) {
+        return {config.GetWorldCenter(), 0};
+    }
+
+    // A fixed-seed shuffle keeps the expected linear time on sorted input
+    // and makes the result reproducible
+    std::vector<ActiveArea> shuffled(footprints);
+    std::mt19937 random(0x5EC7u);
+    std::shuffle(shuffled.begin(), shuffled.end(), random);
+    return Enclose(shuffled);
 }
 
 Vector2 Planet::GetActiveCentroid() const {
     if (!activeArea.has_value()) {
-        return {PLANET_WIDTH / 2, PLANET_HEIGHT / 2};
+        return config.GetWorldCenter();
     }
     return activeArea->centroid;
 }
@@ -92,30 +537,54 @@ float Planet::GetActiveRadius() const {
 }
 
 void Planet::UpdateActiveArea(const std::vector<Colony*>& colonies) {
-    activeArea = CalculateActiveArea(colonies);
-}
+    PROFILE_SCOPE("Planet::UpdateActiveArea");
 
-Vector2 Planet::GridToWorld(int gridX, int gridY) const {
-    return Vector2{
-        gridX * SECT_CORE_RADIUS * 2.0f,
-        gridY * SECT_CORE_RADIUS * 2.0f
-    };
-}
+    // Compare every colony with the footprint the area was last fitted to.
+    // Unchanged colonies and footprints that stay inside cost one comparison.
+    bool refit = !activeArea.has_value() || colonies.size() < colonyFootprints.size();
+    size_t outside = 0;          // Footprints no longer inside the area
+    size_t lastOutside = 0;
+    colonyFootprints.resize(colonies.size(), ActiveArea{{0, 0}, -1.0f});
 
-Vector2 Planet::WorldToGrid(Vector2 worldPos) const {
-    return Vector2{
-        std::floor(worldPos.x / (SECT_CORE_RADIUS * 2.0f)),
-        std::floor(worldPos.y / (SECT_CORE_RADIUS * 2.0f))
-    };
+    for (size_t i = 0; i < colonies.size(); i++) {
+        ActiveArea footprint = {colonies[i]->GetCentroid(), colonies[i]->GetRadius()};
+        ActiveArea& previous = colonyFootprints[i];
+        if (footprint.centroid.x == previous.centroid.x && footprint.centroid.y == previous.centroid.y &&
+            footprint.radius == previous.radius) {
+            continue;
+        }
+
+        if (activeArea.has_value() && !Encloses(*activeArea, footprint)) {
+            outside++;
+            lastOutside = i;
+        } else if (activeArea.has_value() && previous.radius >= 0 &&
+                   Vector2Distance(activeArea->centroid, previous.centroid) + previous.radius >=
+                   activeArea->radius * (1.0f - 1e-4f)) {
+            // A colony that touched the edge moved inward, the area may shrink
+            refit = true;
+        }
+        previous = footprint;
+    }
+
+    if (refit || outside > 1) {
+        activeArea = CalculateActiveArea(colonyFootprints);
+    } else if (outside == 1) {
+        // Only one footprint grew out: the new area has it on its boundary
+        std::vector<ActiveArea> others;
+        others.reserve(colonyFootprints.size());
+        for (size_t i = 0; i < colonyFootprints.size(); i++) {
+            if (i != lastOutside) others.push_back(colonyFootprints[i]);
+        }
+        std::mt19937 random(0x5EC7u);
+        std::shuffle(others.begin(), others.end(), random);
+        activeArea = EncloseWithOne(others, others.size(), colonyFootprints[lastOutside]);
+    }
 }
 
+Vector2 Planet::GridToWorld(int gridX, int gridY) const {
+    return config.GridToWorld(gridX, gridY);
 }
 
-void Planet::DrawPlanetGrid() {
-    // Implement planet grid drawing logic here
-    // For example:
-    for (int i = 0; i < 100; i++) {
-        DrawLine(i * 10, 0, i * 10, GetScreenHeight(), LIGHTGRAY);
-        DrawLine(0, i * 10, GetScreenWidth(), i * 10, LIGHTGRAY);
-    }
+Vector2 Planet::WorldToGrid(Vector2 worldPos) const {
+    return config.WorldToGrid(worldPos);
 }
@@ -9,37 +9,105 @@
 #include <optional>
 #include <memory>
 #include "colony.h"
+#include "chunk_store.h"
+#include "deposit_map.h"
+#include "lru_list.h"
+#include "planet_config.h"
+#include "tiled_grid.h"
+
+// Terrain types stored per grid cell
+namespace Terrain {
+    enum : uint8_t {
+        Ocean,
+        Plains,
+        Forest,
+        Desert,
+        Hills,
+        Mountains,
+        Count
+    };
+}
 
 class Planet {
 public:
-    Planet();
+    explicit Planet(const PlanetConfig& config = PlanetConfig());
     ~Planet();
 
+    // Resizes the surface, dropping terrain and deposits. Not while the simulation runs.
+    void Configure(const PlanetConfig& config);
+    const PlanetConfig& GetConfig() const { return config; }
+    Vector2 GridToWorld(int gridX, int gridY) const;
+    Vector2 WorldToGrid(Vector2 worldPos) const;
+
+    // Smallest circle enclosing every colony's footprint
     struct ActiveArea {
         Vector2 centroid;
-        float radius;  // Distance from centroid to furthest colony
+        float radius;
     };
 
+    // Fills terrain and deposits from the config's seed, one 64x64-cell tile per
+    // job. Each cell depends only on the seed and its coordinates, so the map is
+    // the same bit for bit however many workers run. Replaces the previous map.
+    // A planet that fits its chunk budget is generated whole, a larger one as
+    // its chunks are streamed in.
     void GenerateMap();
+    bool IsMapGenerated() const { return mapGenerated; }
     void AddColony(Colony* colony);
-    std::vector<std::string> GetResourceInfo(std::pair<int, int> location) const;
+
+    // Cell accessors page in a missing chunk. Off the planet a cell is ocean without deposits.
+    uint8_t GetTerrain(std::pair<int, int> location);
+    // Deposits of one cell, a view into the deposit map valid until deposits change or chunks stream
+    DepositSpan GetResourceInfo(std::pair<int, int> location);
+    float GetResourceDeposit(std::pair<int, int> location, ResourceId id);
+    void SetResourceDeposit(std::pair<int, int> location, ResourceId id, float amount);  // 0 removes it
+    // Resident chunks only: EnsureResident the inclusive cell rectangle before a bulk ForEachInRect
+    const DepositMap& GetDeposits() const { return deposits; }
+    void EnsureResident(int minX, int minY, int maxX, int maxY);
+
+    // The surface is kept in memory as 64x64-cell chunks, the tiles of terrain
+    // and deposits. StreamChunks keeps the chunks under the view and around each
+    // colony resident, up to config.residentChunks, and pages out the ones least
+    // recently wanted: edited chunks go to the chunk store, unedited ones are
+    // dropped and regenerated from the seed. Chunks paged in on demand may
+    // exceed the budget until the next StreamChunks.
+    void StreamChunks(Rectangle view);  // World rectangle under the camera, empty for none
+    size_t GetChunkCount() const { return chunkDirty.size(); }
+    size_t GetResidentChunkCount() const { return residentChunks.Size(); }
+    size_t GetChunkFileSize() const { return chunkStore.GetFileSize(); }
+    size_t GetMemoryUsage() const { return terrain.GetMemoryUsage() + deposits.GetMemoryUsage(); }
+
     void Update();
-    void Draw(float scale);
-    void DrawPlanetGrid();
-    void UpdateActiveArea(const std::vector<Colony*>& colonies);
+
+    void UpdateActiveArea(const std::vector<Colony*>& colonies);  // Refits only when a footprint left the area
     Vector2 GetActiveCentroid() const;
     float GetActiveRadius() const;
 
 private:
-    std::vector<std::vector<int>> map; // 2D grid representing the planet's surface
+    PlanetConfig config;
+    TiledGrid<uint8_t> terrain;            // Terrain type of each grid cell
     std::vector<Colony*> colonies;
-    std::map<std::pair<int, int>, std::vector<std::string>> resources; // Resources at each location
-    std::pair<int, int> size; // Planet dimensions
+    DepositMap deposits;                   // Resource deposits of each grid cell
+    bool mapGenerated;
+    void GenerateTile(int tileX, int tileY, std::vector<Deposit>& records);
+
+    // Chunk streaming, chunk ids are tile indices in row-major order
+    ChunkStore chunkStore;                  // Edited chunks that were paged out
+    LruList residentChunks;                 // Most recently wanted first
+    std::vector<uint8_t> chunkDirty;        // Edited since generated or read back
+    std::vector<uint32_t> chunkWantedPass;  // Last StreamChunks pass that wanted each chunk
+    uint32_t streamPass;
+    std::vector<uint32_t> wantedChunks;     // Reused by StreamChunks
+    std::vector<uint32_t> chunksToLoad;
+    std::vector<uint8_t> chunkBuffer;       // A chunk serialized for the store
+    void ResetChunks();
+    void PageIn(uint32_t chunk, std::vector<Deposit>& records);  // Distinct chunks may load in parallel
+    void PageInChunks(const std::vector<uint32_t>& chunks);
+    bool PageOut(uint32_t chunk);           // False when an edited chunk could not be stored
+    void WantChunks(int minX, int minY, int maxX, int maxY, size_t limit);
     int time; // Game time
     std::optional<ActiveArea> activeArea;
-    ActiveArea CalculateActiveArea(const std::vector<Colony*>&) const;
-    Vector2 GridToWorld(int gridX, int gridY) const;
-    Vector2 WorldToGrid(Vector2 worldPos) const;
+    std::vector<ActiveArea> colonyFootprints;  // Per colony index, as of the last UpdateActiveArea
+    ActiveArea CalculateActiveArea(const std::vector<ActiveArea>& footprints) const;
 };
 
 #endif // PLANET_H
@@ -0,0 +1,49 @@
+#ifndef PLANET_CONFIG_H
+#define PLANET_CONFIG_H
+
+#include "raylib.h"
+#include <cmath>
+#include <cstdint>
+
+// Shape of the planet surface and the seed of its map. Everything that maps
+// between grid cells and world space, or needs the planet's extent, reads it
+// from here.
+struct PlanetConfig {
+    static constexpr int MAX_CELLS = 4096;  // Per side
+
+    int width = 20;           // Grid cells
+    int height = 20;
+    float cellSize = 100.0f;  // World units per cell, one sect core across
+    uint32_t seed = 1;        // Map generation, the same seed always gives the same map
+    int residentChunks = 1024;  // 64x64-cell chunks kept in memory, the rest are paged out
+
+    float GetWorldWidth() const { return width * cellSize; }
+    float GetWorldHeight() const { return height * cellSize; }
+    Vector2 GetWorldCenter() const { return {GetWorldWidth() / 2, GetWorldHeight() / 2}; }
+    float GetSectRadius() const { return cellSize / 2; }  // A sect's core spans its cell
+
+    bool Contains(int x, int y) const { return x >= 0 && x < width && y >= 0 && y < height; }
+
+    // Top-left corner of a cell, and the cell under a world position
+    Vector2 GridToWorld(int x, int y) const { return {x * cellSize, y * cellSize}; }
+    Vector2 WorldToGrid(Vector2 worldPos) const {
+        return {std::floor(worldPos.x / cellSize), std::floor(worldPos.y / cellSize)};
+    }
+
+    // Same dimensions limited to what the planet supports
+    PlanetConfig Clamped() const {
+        PlanetConfig config = *this;
+        config.width = width < 1 ? 1 : (width > MAX_CELLS ? MAX_CELLS : width);
+        config.height = height < 1 ? 1 : (height > MAX_CELLS ? MAX_CELLS : height);
+        config.residentChunks = residentChunks < 1 ? 1 : residentChunks;
+        return config;
+    }
+
+    bool operator==(const PlanetConfig& other) const {
+        return width == other.width && height == other.height && cellSize == other.cellSize && seed == other.seed &&
+               residentChunks == other.residentChunks;
+    }
+    bool operator!=(const PlanetConfig& other) const { return !(*this == other); }
+};
+
+#endif // PLANET_CONFIG_H
@@ -0,0 +1,80 @@
+#include "planet_grid_layer.h"
+#include "log.h"
+#include <algorithm>
+#include <cmath>
+
+PlanetGridLayer::PlanetGridLayer() : gridLevel(0) {
+}
+
+PlanetGridLayer::~PlanetGridLayer() {
+    UnloadGridTiles();
+}
+
+int PlanetGridLayer::GetGridLevel(float zoom) {
+    return static_cast<int>(std::lround(std::log2(zoom)));
+}
+
+void PlanetGridLayer::UnloadGridTiles() {
+    for (auto& entry : gridTiles) {
+        UnloadRenderTexture(entry.second.texture);
+    }
+    gridTiles.clear();
+}
+
+void PlanetGridLayer::Update(const PlanetConfig& config, float zoom) {
+    // Tiles only depend on the planet shape and the zoom level
+    if (gridTilesConfig != config) {
+        UnloadGridTiles();
+        gridTilesConfig = config;
+    }
+
+    gridLevel = GetGridLevel(zoom);
+    if (gridTiles.count(gridLevel)) {
+        return;
+    }
+
+    // Pixels per cell at this level, then enough cells per tile to keep lines apart
+    float cellPixels = config.cellSize * std::ldexp(1.0f, gridLevel);
+    int cellsPerTile = 1;
+    while (cellPixels * cellsPerTile < MIN_GRID_TILE_PIXELS && cellsPerTile < std::max(config.width, config.height)) {
+        cellsPerTile *= 2;
+    }
+    int tilePixels = std::max(1, std::min(static_cast<int>(std::lround(cellPixels * cellsPerTile)), MAX_GRID_TILE_PIXELS));
+
+    // One line along the top and left edges, white so Draw can tint it
+    GridTile tile;
+    tile.cellsPerTile = cellsPerTile;
+    tile.texture = LoadRenderTexture(tilePixels, tilePixels);
+    SetTextureWrap(tile.texture.texture, TEXTURE_WRAP_REPEAT);
+    SetTextureFilter(tile.texture.texture, TEXTURE_FILTER_BILINEAR);
+
+    BeginTextureMode(tile.texture);
+    ClearBackground(BLANK);
+    DrawRectangle(0, 0, tilePixels, 1, WHITE);
+    DrawRectangle(0, 0, 1, tilePixels, WHITE);
+    EndTextureMode();
+
+    gridTiles[gridLevel] = tile;
+    LOG_DEBUG("Planet grid tile for zoom level %d: %d px, %d cells", gridLevel, tilePixels, cellsPerTile);
+}
+
+void PlanetGridLayer::Draw(const PlanetConfig& config, float zoom, Color tint) const {
+    auto it = gridTiles.find(gridLevel);
+    if (it == gridTiles.end()) {
+        return;  // Update has not run for this zoom yet
+    }
+
+    const GridTile& tile = it->second;
+    float tileWorld = config.cellSize * tile.cellsPerTile;
+    float width = config.GetWorldWidth();
+    float height = config.GetWorldHeight();
+    float tilePixels = static_cast<float>(tile.texture.texture.width);
+
+    // The source spans as many tiles as fit on the planet and wraps; its negative
+    // height flips the render texture, which is stored upside down
+    Rectangle source = {0.0f, 0.0f, width / tileWorld * tilePixels, -height / tileWorld * tilePixels};
+    DrawTexturePro(tile.texture.texture, source, {0.0f, 0.0f, width, height}, {0.0f, 0.0f}, 0.0f, tint);
+
+    // The tiles only carry their top and left edges; close the far sides of the planet
+    DrawRectangleLinesEx({0.0f, 0.0f, width, height}, 1.0f / zoom, tint);
+}
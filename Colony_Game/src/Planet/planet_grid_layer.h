@@ -0,0 +1,39 @@
+#ifndef PLANET_GRID_LAYER_H
+#define PLANET_GRID_LAYER_H
+
+#include "raylib.h"
+#include <map>
+#include "planet_config.h"
+
+// Cached drawing of the planet's cell grid. The grid is periodic, so one tile
+// of it is rasterized per zoom level and drawn as a single repeating textured
+// quad over the whole planet. The tiles are GPU textures: create the layer
+// once the window is open and destroy it before the window closes.
+class PlanetGridLayer {
+public:
+    PlanetGridLayer();
+    ~PlanetGridLayer();
+
+    PlanetGridLayer(const PlanetGridLayer&) = delete;
+    PlanetGridLayer& operator=(const PlanetGridLayer&) = delete;
+
+    // Renders to a texture, so it must run outside BeginMode2D
+    void Update(const PlanetConfig& config, float zoom);
+    void Draw(const PlanetConfig& config, float zoom, Color tint) const;  // Inside BeginMode2D
+
+private:
+    // Cached grid tiles by zoom level (log2 of the zoom, rounded)
+    struct GridTile {
+        RenderTexture2D texture;
+        int cellsPerTile;  // More than one when a single cell would be only a few pixels
+    };
+    std::map<int, GridTile> gridTiles;
+    PlanetConfig gridTilesConfig;       // Planet shape the tiles were drawn for
+    int gridLevel;                      // Level of the current zoom
+    void UnloadGridTiles();
+    static int GetGridLevel(float zoom);
+    static constexpr int MIN_GRID_TILE_PIXELS = 16;   // Finer grids are thinned to every 2nd, 4th... line
+    static constexpr int MAX_GRID_TILE_PIXELS = 1024;
+};
+
+#endif // PLANET_GRID_LAYER_H
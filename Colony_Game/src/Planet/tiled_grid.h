@@ -0,0 +1,100 @@
+#ifndef TILED_GRID_H
+#define TILED_GRID_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// 2D grid of cells stored in square tiles, each tile one contiguous block.
+//
+// Neighbouring cells in both directions share a tile, so area walks stay in
+// cache, and tiles are only allocated on first write: a 4096x4096 planet
+// costs its tile table until something is stored in it. Reads of cells in
+// unwritten tiles return a default value. Coordinates are not bounds checked;
+// callers test them against the planet first.
+template<typename T>
+class TiledGrid {
+public:
+    static constexpr int TILE_SHIFT = 6;
+    static constexpr int TILE_SIZE = 1 << TILE_SHIFT;  // 64x64 cells per tile
+    static constexpr int TILE_MASK = TILE_SIZE - 1;
+    static constexpr size_t TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+    TiledGrid() : width(0), height(0), tilesX(0), tilesY(0), empty() {}
+
+    // Drops every tile
+    void Resize(int newWidth, int newHeight) {
+        width = newWidth;
+        height = newHeight;
+        tilesX = (width + TILE_MASK) >> TILE_SHIFT;
+        tilesY = (height + TILE_MASK) >> TILE_SHIFT;
+        tiles.clear();
+        tiles.resize(static_cast<size_t>(tilesX) * tilesY);
+    }
+
+    int GetWidth() const { return width; }
+    int GetHeight() const { return height; }
+
+    const T& Get(int x, int y) const {
+        const std::unique_ptr<T[]>& tile = tiles[TileIndex(x, y)];
+        return tile ? tile[CellIndex(x, y)] : empty;
+    }
+
+    // Allocates the cell's tile if this is its first write
+    T& At(int x, int y) {
+        std::unique_ptr<T[]>& tile = tiles[TileIndex(x, y)];
+        if (!tile) {
+            tile.reset(new T[TILE_CELLS]());
+        }
+        return tile[CellIndex(x, y)];
+    }
+
+    // Allocates a whole tile for writing. Tiles are independent blocks, so
+    // different tiles may be allocated and filled from different threads.
+    T* AllocateTile(int tileX, int tileY) {
+        std::unique_ptr<T[]>& tile = tiles[static_cast<size_t>(tileY) * tilesX + tileX];
+        if (!tile) {
+            tile.reset(new T[TILE_CELLS]());
+        }
+        return tile.get();
+    }
+
+    // Frees a tile; its cells read as the default value again
+    void ReleaseTile(int tileX, int tileY) {
+        tiles[static_cast<size_t>(tileY) * tilesX + tileX].reset();
+    }
+
+    // Whole tile as one block, nullptr if never written. Cells are row-major within the tile.
+    const T* GetTile(int tileX, int tileY) const { return tiles[static_cast<size_t>(tileY) * tilesX + tileX].get(); }
+    int GetTilesX() const { return tilesX; }
+    int GetTilesY() const { return tilesY; }
+
+    size_t GetAllocatedTileCount() const {
+        size_t count = 0;
+        for (const auto& tile : tiles) {
+            count += tile ? 1 : 0;
+        }
+        return count;
+    }
+
+    size_t GetMemoryUsage() const {
+        return GetAllocatedTileCount() * TILE_CELLS * sizeof(T) + tiles.size() * sizeof(tiles[0]);
+    }
+
+private:
+    size_t TileIndex(int x, int y) const {
+        return static_cast<size_t>(y >> TILE_SHIFT) * tilesX + (x >> TILE_SHIFT);
+    }
+    static size_t CellIndex(int x, int y) {
+        return (static_cast<size_t>(y & TILE_MASK) << TILE_SHIFT) | (x & TILE_MASK);
+    }
+
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    std::vector<std::unique_ptr<T[]>> tiles;  // Row-major tile table
+    T empty;
+};
+
+#endif // TILED_GRID_H
@@ -0,0 +1,44 @@
+#include "resource.h"
+#include <algorithm>
+
+ResourceRegistry::ResourceRegistry() {
+    // Same order as the Resource enum
+    names = {
+        "Energy", "Iron", "Food", "Water", "Fuel", "RareMetal",
+        "Tools", "Structures", "Cargo", "Research", "Credits"
+    };
+}
+
+ResourceRegistry& ResourceRegistry::Global() {
+    static ResourceRegistry registry;
+    return registry;
+}
+
+bool ResourceRegistry::Register(const std::string& name, ResourceId& id) {
+    if (Find(name, id)) {
+        return true;
+    }
+    if (names.size() >= MAX_RESOURCES) {
+        return false;
+    }
+    id = static_cast<ResourceId>(names.size());
+    names.push_back(name);
+    return true;
+}
+
+bool ResourceRegistry::Find(const std::string& name, ResourceId& id) const {
+    for (size_t i = 0; i < names.size(); i++) {
+        if (names[i] == name) {
+            id = static_cast<ResourceId>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+float TransferResource(ResourceVector& from, ResourceVector& to, ResourceId id, float amount) {
+    float moved = std::max(0.0f, std::min(amount, from[id]));
+    from[id] -= moved;
+    to[id] += moved;
+    return moved;
+}
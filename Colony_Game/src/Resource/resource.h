@@ -0,0 +1,100 @@
+#ifndef RESOURCE_H
+#define RESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+typedef uint8_t ResourceId;
+
+// Built-in resources, registered first so their ids are fixed
+namespace Resource {
+    enum : ResourceId {
+        Energy,
+        Iron,
+        Food,
+        Water,
+        Fuel,
+        RareMetal,
+        Tools,
+        Structures,
+        Cargo,
+        Research,
+        Credits,
+        BuiltinCount
+    };
+}
+
+// Width of every resource vector, the most resources the registry can hold
+const size_t MAX_RESOURCES = 16;
+
+// Global name <-> id mapping for resources
+class ResourceRegistry {
+public:
+    static ResourceRegistry& Global();
+
+    // Returns the id of an existing resource or registers a new one.
+    // Returns false when the registry is full.
+    bool Register(const std::string& name, ResourceId& id);
+    bool Find(const std::string& name, ResourceId& id) const;
+    const char* GetName(ResourceId id) const { return names[id].c_str(); }
+    size_t GetCount() const { return names.size(); }
+
+private:
+    ResourceRegistry();
+    std::vector<std::string> names;  // Indexed by id
+};
+
+// Fixed-width amounts of every resource. All arithmetic runs over the whole
+// array, so it compiles to a handful of SIMD instructions.
+struct ResourceVector {
+    alignas(16) float amounts[MAX_RESOURCES];
+
+    ResourceVector() { Clear(); }
+
+    float& operator[](ResourceId id) { return amounts[id]; }
+    float operator[](ResourceId id) const { return amounts[id]; }
+
+    void Clear() {
+        for (size_t i = 0; i < MAX_RESOURCES; i++) {
+            amounts[i] = 0.0f;
+        }
+    }
+
+    ResourceVector& operator+=(const ResourceVector& other) {
+        for (size_t i = 0; i < MAX_RESOURCES; i++) {
+            amounts[i] += other.amounts[i];
+        }
+        return *this;
+    }
+
+    ResourceVector& operator-=(const ResourceVector& other) {
+        for (size_t i = 0; i < MAX_RESOURCES; i++) {
+            amounts[i] -= other.amounts[i];
+        }
+        return *this;
+    }
+
+    // this += other * scale
+    void AddScaled(const ResourceVector& other, float scale) {
+        for (size_t i = 0; i < MAX_RESOURCES; i++) {
+            amounts[i] += other.amounts[i] * scale;
+        }
+    }
+
+    bool IsEmpty() const {
+        for (size_t i = 0; i < MAX_RESOURCES; i++) {
+            if (amounts[i] != 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Moves up to amount of one resource, limited by what the source holds.
+// Returns the amount actually moved.
+float TransferResource(ResourceVector& from, ResourceVector& to, ResourceId id, float amount);
+
+#endif // RESOURCE_H
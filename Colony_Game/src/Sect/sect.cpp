@@ -1,207 +1,191 @@
 #include "sect.h"
-#include <iostream>
+#include "log.h"
+#include <algorithm>
 
-Sect::Sect()
-    : defaultCoreRadius(50.0f),
-      coreRadius(defaultCoreRadius),
+Sect::Sect(Pool<Unit>& unitPool, float coreRadius)
+    : defaultCoreRadius(coreRadius),
       color(GRAY),
       SectPosition({0, 0}),
       location({0, 0}),
+      unitPool(unitPool),
       units(),
+      unitHandles(),
       core(nullptr),
+      storeId(UnitStore::Global().AddSect()),
       development_percentage(0.0f),
-      production_priority(),
-      resources()
+      previous_development(0.0f),
+      resources(),
+      shipmentCount(0),
+      queuedTransferCount(0),
+      sectViewCenter({0, 0}),
+      sectViewCoreRadius(0.0f)
 {
     CreateInitialUnits();
 }
 
 Sect::~Sect() {
-    for (auto unit : units) {
-        delete unit;
+    // No-op for placeholders and for units already released by a bulk Pool::Clear()
+    for (const auto& handle : unitHandles) {
+        unitPool.Destroy(handle);
     }
+    UnitStore::Global().RemoveSect(storeId);
 }
 
-void Sect::AddUnit(Unit* unit) {
-    units.push_back(unit);
-    std::cout << "New unit added to the sect." << std::endl;
+Unit* Sect::MaterializeUnit(UnitType type) {
+    size_t slot = UnitTypeIndex(type);
+    if (!units[slot]) {
+        unitHandles[slot] = unitPool.Create(type);
+        units[slot] = unitPool.Get(unitHandles[slot]);
+        UnitStore::Global().SetSect(units[slot]->GetStoreHandle(), storeId);
+    }
+    return units[slot];
 }
 
+Unit* Sect::GetUnit(UnitType type) {
+    return MaterializeUnit(type);
+}
+
+size_t Sect::GetMaterializedUnitCount() const {
+    size_t count = 0;
+    for (auto unit : units) {
+        count += unit ? 1 : 0;
+    }
+    return count;
+}
 
 void Sect::ConsumeResources() {
     // TODO: Implement resource consumption logic
-    std::cout << "Sect resources consumed." << std::endl;
+    LOG_DEBUG("Sect resources consumed.");
 }
 
-void Sect::BuildUnit(std::string unit_type) {
-    // TODO: Implement unit building logic
-    std::cout << "Building new unit of type: " << unit_type << std::endl;
+Unit* Sect::BuildUnit(UnitType type) {
+    // TODO: Charge construction cost and time
+    Unit* unit = MaterializeUnit(type);
+    if (!unit->IsActive()) {
+        unit->Start();
+    }
+    LOG_INFO("Building new unit of type: %s", GetUnitTypeName(type));
+    return unit;
 }
 
 void Sect::UpgradeUnit(Unit* unit) {
     // TODO: Implement unit upgrade logic
-    std::cout << "Upgrading unit." << std::endl;
+    LOG_INFO("Upgrading unit.");
 }
 
 void Sect::Update() {
-    // TODO: Implement sect update logic
-    std::cout << "Sect updated." << std::endl;
-}
-
-void Sect::CreateInitialUnits() {
-    std::vector<std::string> unit_types = {
-        "Extraction", "Farming", "Energy", "Manufacture",
-        "Construction", "Transport", "Research", "Commerce"
-    };
-
-    for (const auto& type : unit_types) {
-        Unit* unit = new Unit(type);
-        if (type == "Extraction") {
-            unit->SetStatus("active");
-            core = unit; // Set the Extraction unit as the core
-        } else {
-            unit->SetStatus("inactive");
+    previous_development = development_percentage;
+
+    // Apply what this sect's units produced and consumed in the last UnitStore tick
+    const UnitStore::SectLedger& ledger = UnitStore::Global().GetSectLedger(storeId);
+    resources += ledger.produced;
+    resources -= ledger.consumed;
+
+    // Shipments only take what is in store after this tick's production
+    for (size_t i = 0; i < shipmentCount; i++) {
+        const ResourceTransfer& shipment = shipments[i];
+        float amount = std::min(shipment.amount, std::max(0.0f, resources[shipment.id]));
+        if (amount > 0.0f) {
+            QueueTransfer(shipment.to, shipment.id, amount);
         }
-        AddUnit(unit);
     }
 
-    std::cout << "All initial units created for the sect." << std::endl;
+    LOG_DEBUG("Sect updated.");
 }
 
-void Sect::DrawInColonyView(Vector2 pos, float scale) {
-    coreRadius = defaultCoreRadius * scale; // Scale the radius based on zoom level
-
-    // Draw main sect circle (smaller in Colony view)
-    DrawCircle(pos.x, pos.y, coreRadius, color);
-    //DrawCircleLines(pos.x, pos.y, radius, BLACK);
-
-
-
-    // Draw active units indicator as small dots around the sect
-    float indicatorRadius = coreRadius * 0.3f;
-
-    for (size_t i = 0; i < units.size(); i++) {
-        float angle = (90.0f - (i * 45.0f)) * DEG2RAD;  // 8 units, 45 degrees apart
-        Vector2 indicatorPos = {
-            pos.x + (coreRadius * 1.4f) * cosf(angle),
-            pos.y - (coreRadius * 1.4f) * sinf(angle)
-        };
-
-        if ( units[i]->GetStatus() == "active" ) {DrawCircle(indicatorPos.x, indicatorPos.y, indicatorRadius, GREEN);}
-        else {DrawCircle(indicatorPos.x, indicatorPos.y, indicatorRadius, GRAY);}
-    }
-
-    // Draw development percentage as a progress arc
-    if (development_percentage > 0) {
-        DrawRing(
-            pos,
-            coreRadius * 1.1f,
-            coreRadius * 1.2f,
-            0,
-            development_percentage * 360,
-            32,
-            Fade(GREEN, 0.5f)
-        );
+bool Sect::AddShipment(Sect* to, ResourceId id, float amountPerTick) {
+    if (shipmentCount == MAX_SHIPMENTS) {
+        return false;
     }
+    shipments[shipmentCount++] = ResourceTransfer{to, id, amountPerTick};
+    return true;
 }
 
-void Sect::DrawInSectView(Vector2 position) {
-    float coreRadius = GetScreenHeight() * 0.3f;  // Core takes 60% of screen height
-
-    // Draw the main core circle
-    DrawCircle(position.x, position.y, coreRadius, LIGHTGRAY);
-    DrawCircleLines(position.x, position.y, coreRadius, BLACK);
-
-    // Draw core information
-    DrawText(TextFormat("Development: %.1f%%", development_percentage * 100),
-            position.x - MeasureText("Development: 100.0%", 20)/2,
-            position.y - 10,
-            20,
-            BLACK);
-
-    // Draw resource stats in the core
-    DrawResourceStats(position, coreRadius);
-
-    // Draw the units around the core
-    float unitRadius = coreRadius * 0.2f;  // Units are 20% the size of core
-    float orbitRadius = coreRadius * 1.4f; // Distance from core to units
+void Sect::QueueTransfer(Sect* to, ResourceId id, float amount) {
+    // One entry per shipment, so the queue cannot overflow
+    queuedTransfers[queuedTransferCount++] = ResourceTransfer{to, id, amount};
+}
 
-    for (size_t i = 0; i < units.size(); ++i) {
-        // Start from 90 degrees (top) and go clockwise
-        float angle = (90.0f - (i * 45.0f)) * DEG2RAD;  // 8 units, 45 degrees apart
+void Sect::ApplyQueuedTransfers() {
+    for (size_t i = 0; i < queuedTransferCount; i++) {
+        const ResourceTransfer& transfer = queuedTransfers[i];
+        ::TransferResource(resources, transfer.to->resources, transfer.id, transfer.amount);
+    }
+    queuedTransferCount = 0;
+}
 
-        Vector2 unitPos = {
-            position.x + orbitRadius * cosf(angle),
-            position.y - orbitRadius * sinf(angle)  // Subtract because Y grows downward
-        };
+void Sect::CreateInitialUnits() {
+    // Every unit type starts as an inactive placeholder; only the core is materialized
+    UnitStore::Global().AddPlaceholders(storeId, ALL_UNIT_TYPES_MASK);
 
-        // Store the position for click detection
-        units[i]->SetUnitPosInSectView(unitPos);
-        units[i]->SetUnitRadiusInSectView(unitRadius);
+    core = MaterializeUnit(UnitType::Extraction);
+    core->SetStatus(UnitStatus::Active);
 
-        // Draw the unit circle
-        Color fillColor = units[i]->GetStatus() == "active" ? GREEN : GRAY;
-        DrawCircle(unitPos.x, unitPos.y, unitRadius, fillColor);
-        DrawCircleLines(unitPos.x, unitPos.y, unitRadius, BLACK);
+    LOG_DEBUG("All initial units created for the sect.");
+}
 
-        // Draw first letter of unit type (only in Sect view)
-        const char* unitType = units[i]->GetUnitType().c_str();
-        char firstLetter[2] = {unitType[0], '\0'};
+SectSnapshot Sect::GetSnapshot() const {
+    SectSnapshot snapshot;
+    snapshot.sect = nullptr;  // The publisher fills it in, it holds the sect as non-const
+    snapshot.position = SectPosition;
+    snapshot.coreRadius = defaultCoreRadius;
+    snapshot.color = color;
+    snapshot.activeMask = GetActiveMask();
+    snapshot.development = development_percentage;
+    snapshot.previousDevelopment = previous_development;
+    return snapshot;
+}
 
-        // Center the letter in the circle
-        int fontSize = (int)(unitRadius);
-        Vector2 textSize = MeasureTextEx(GetFontDefault(), firstLetter, fontSize, 1);
-        Vector2 textPos = {
-            unitPos.x - textSize.x/2,
-            unitPos.y - textSize.y/2
-        };
+SectViewState Sect::GetViewState() const {
+    SectViewState state;
+    state.development = development_percentage;
+    state.activeMask = GetActiveMask();
+    state.resources = resources;
+    return state;
+}
 
-        DrawText(firstLetter, textPos.x, textPos.y, fontSize, BLACK);
+SectDetail Sect::GetColonyViewDetail(float screenCoreRadius) {
+    if (screenCoreRadius >= FULL_DETAIL_PIXELS) {
+        return SectDetail::Full;
     }
-
-    // Draw the transparent right panel
-    DrawTransparentRightPanel();
+    if (screenCoreRadius >= DOT_DETAIL_PIXELS) {
+        return SectDetail::Dot;
+    }
+    return SectDetail::Colony;
 }
 
-void Sect::DrawResourceStats(Vector2 position, float coreRadius) {
-    // Draw production/consumption stats in the core
-    const float statsY = position.y - coreRadius * 0.5f;
-    const float statsSpacing = 25;
-    int statIndex = 0;
+SectDrawItem Sect::BuildColonyViewItem(const SectSnapshot& snapshot, float scale, float alpha) {
+    SectDrawItem item;
+    item.position = snapshot.position;
+    item.coreRadius = snapshot.coreRadius * scale; // Scale the radius based on zoom level
+    item.color = snapshot.color;
+    item.activeMask = snapshot.activeMask;
+    // Development is interpolated between ticks
+    item.development = snapshot.previousDevelopment +
+                       (snapshot.development - snapshot.previousDevelopment) * alpha;
+    return item;
+}
 
-    // Example resource stats (replace with actual resource tracking)
-    std::vector<std::pair<const char*, int>> stats = {
-        {"Energy: ", 100},
-        {"Iron: ", 50},
-        {"Food: ", 75},
+Vector2 Sect::GetUnitSlotPosition(size_t slot, Vector2 center, float orbitRadius) const {
+    // Start from 90 degrees (top) and go clockwise
+    float angle = (90.0f - (slot * 45.0f)) * DEG2RAD;  // 8 units, 45 degrees apart
+    return Vector2{
+        center.x + orbitRadius * cosf(angle),
+        center.y - orbitRadius * sinf(angle)  // Subtract because Y grows downward
     };
-
-    for (const auto& stat : stats) {
-        const char* text = TextFormat("%s%d", stat.first, stat.second);
-        DrawText(text,
-                position.x - MeasureText(text, 20)/2,
-                statsY + statIndex * statsSpacing,
-                20,
-                BLACK);
-        statIndex++;
-    }
 }
 
+int Sect::GetUnitSlotAt(Vector2 screenPosition) const {
+    float unitRadius = sectViewCoreRadius * 0.2f;
+    float orbitRadius = sectViewCoreRadius * 1.4f;
 
-void Sect::DrawTransparentRightPanel() {
-    int panelWidth = 100;
-    Rectangle panel = {
-        (float)GetScreenWidth() - panelWidth,
-        0,
-        (float)panelWidth,
-        (float)GetScreenHeight()
-    };
-    DrawRectangleRec(panel, Fade(WHITE, 0.5f));
-
-    // Draw panel content (e.g., notifications, alerts)
-    DrawText("Updates",
-            GetScreenWidth() - panelWidth + 10,
-            10,
-            20,
-            BLACK);
+    for (size_t i = 0; i < UNIT_TYPE_COUNT; i++) {
+        Vector2 unitPos = GetUnitSlotPosition(i, sectViewCenter, orbitRadius);
+        float dx = screenPosition.x - unitPos.x;
+        float dy = screenPosition.y - unitPos.y;
+        if (dx * dx + dy * dy <= unitRadius * unitRadius) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
 }
@@ -6,35 +6,118 @@
 #include <utility>
 #include <map>
 #include "unit.h"
+#include "pool.h"
 #include <cmath>  // Add this for cosf, sinf, etc.
 
+class Sect;
+
+// Everything needed to draw one sect in the colony view, resolved ahead of the draw calls
+struct SectDrawItem {
+    Vector2 position;
+    float coreRadius;
+    Color color;
+    uint8_t activeMask;
+    float development;  // Interpolated between the last two ticks
+};
+
+// Level of detail in the colony and planet views, picked from how many pixels
+// a sect's core covers on screen
+enum class SectDetail {
+    Full,    // Core, unit indicators and development arc
+    Dot,     // One quad per sect
+    Colony   // Sects are not drawn, each colony draws one impostor instead
+};
+
+// Per-tick state of a sect as published to the render thread
+struct SectSnapshot {
+    Sect* sect;  // For selection only, the render thread must not read it
+    Vector2 position;
+    float coreRadius;  // At zoom 1
+    Color color;
+    uint8_t activeMask;
+    float development;
+    float previousDevelopment;
+};
+
+// A resource transfer queued during a parallel tick, applied in the merge phase
+struct ResourceTransfer {
+    Sect* to;
+    ResourceId id;
+    float amount;
+};
+
+// What the sect view shows of one sect
+struct SectViewState {
+    float development;
+    uint8_t activeMask;
+    ResourceVector resources;
+};
+
+// A sect owns no memory of its own, only its ledger and units in the
+// UnitStore, which lets a colony drop its sects without destroying each one
 class Sect {
 public:
-    Sect();
+    // Units are allocated from the owning colony's unit pool. The core radius
+    // comes from the planet, see PlanetConfig::GetSectRadius.
+    Sect(Pool<Unit>& unitPool, float coreRadius);
     ~Sect();
 
-    void AddUnit(Unit* unit);
+    Sect(const Sect&) = delete;
+    Sect& operator=(const Sect&) = delete;
+
+    Unit* BuildUnit(UnitType type);
     void CalculateProduction();
     void ConsumeResources();
-    void BuildUnit(std::string unit_type);
     void UpgradeUnit(Unit* unit);
     void Update();
-    void Draw(Vector2 position);
-    void DrawInColonyView(Vector2 position, float scale);
-    void DrawInSectView(Vector2 position);
+
+    // Standing shipments to other sects. Each Update queues up to the amount
+    // of every shipment as a transfer, touching only this sect, and the colony
+    // applies the queues once all its sects have ticked, one sect after another.
+    // Go through Colony::AddShipment, which checks the road route.
+    bool AddShipment(Sect* to, ResourceId id, float amountPerTick);  // False when MAX_SHIPMENTS are standing
+    template <typename Fn>
+    size_t RemoveShipmentsIf(Fn fn);  // Returns how many are left
+    size_t GetShipmentCount() const { return shipmentCount; }
+    void ApplyQueuedTransfers();  // Merge phase, on one thread
+    static constexpr size_t MAX_SHIPMENTS = 4;
+
+    // State copied out for the render thread
+    SectSnapshot GetSnapshot() const;
+    SectViewState GetViewState() const;
+
+    static SectDrawItem BuildColonyViewItem(const SectSnapshot& snapshot, float scale, float alpha);
+    static void DrawColonyViewItems(const SectDrawItem* items, size_t count, SectDetail detail);  // One batch for all
+    static SectDetail GetColonyViewDetail(float screenCoreRadius);  // Core radius in pixels
+    static constexpr float COLONY_VIEW_REACH = 1.7f;  // Indicator dots extend this many core radii out
+    static constexpr float FULL_DETAIL_PIXELS = 4.0f;   // Smallest core drawn in full
+    static constexpr float DOT_DETAIL_PIXELS = 1.0f;    // Smallest core drawn as a dot
+    void DrawInSectView(Vector2 position, const SectViewState& state);
 
     // Setters
     void SetPosition(Vector2 position) {SectPosition = position;}
 
     // Getters
     Vector2 GetPosition() const {return SectPosition;}
-    const std::vector<Unit*>& GetUnits() const { return units; }
-    float GetRadius() const { return coreRadius; }
+    uint32_t GetStoreId() const { return storeId; }
+    uint8_t GetActiveMask() const { return UnitStore::Global().GetActiveMask(storeId); }
+    uint8_t GetInactiveMask() const { return UnitStore::Global().GetInactiveMask(storeId); }
+    bool IsUnitActive(UnitType type) const { return (GetActiveMask() & UnitTypeBit(type)) != 0; }
+    float GetResource(ResourceId id) const { return resources[id]; }
+    const ResourceVector& GetResources() const { return resources; }
+    float GetDevelopment() const { return development_percentage; }
+    ResourceVector& GetResources() { return resources; }
+    // Inactive units are placeholders until something needs the full record:
+    // FindUnit returns nullptr for them, GetUnit materializes them
+    Unit* FindUnit(UnitType type) const { return units[UnitTypeIndex(type)]; }
+    Unit* GetUnit(UnitType type);
+    size_t GetMaterializedUnitCount() const;
+    int GetUnitSlotAt(Vector2 screenPosition) const;  // Hit test against the last sect view, -1 if none
+    float GetRadius() const { return defaultCoreRadius; }  // At zoom 1, the colony view scales it
 
 private:
     // Geometric/Visual properties (basic types first)
-    float defaultCoreRadius;        // Constant value
-    float coreRadius;               // Derived from default
+    float defaultCoreRadius;        // At zoom 1, set by the colony
     Color color;                    // Visual property
 
     // Position/Location data
@@ -42,18 +125,44 @@ private:
     std::pair<int, int> location;   // Grid location
 
     // Core gameplay elements
-    std::vector<Unit*> units;       // Collection of units
+    Pool<Unit>& unitPool;           // Where the units below live
+    Unit* units[UNIT_TYPE_COUNT];   // One slot per unit type, nullptr while a placeholder
+    Pool<Unit>::Handle unitHandles[UNIT_TYPE_COUNT];  // Pool handles of the units above
     Unit* core;                     // Reference to core unit
+    uint32_t storeId;               // Id of this sect's ledger in the UnitStore
     float development_percentage;    // Progress tracking
+    float previous_development;      // Value before the last tick, for render interpolation
 
     // Resource management
-    std::vector<std::string> production_priority;  // Order of production
-    std::map<std::string, int> resources;         // Resource storage
+    ResourceVector resources;                     // Resource storage
+    ResourceTransfer shipments[MAX_SHIPMENTS];    // Standing, sent every tick
+    uint8_t shipmentCount;
+    ResourceTransfer queuedTransfers[MAX_SHIPMENTS];  // This tick's, until the merge phase
+    uint8_t queuedTransferCount;
+
+    // Layout of the last DrawInSectView, for unit picking
+    Vector2 sectViewCenter;
+    float sectViewCoreRadius;
 
     // Private member functions
     void CreateInitialUnits();
+    Unit* MaterializeUnit(UnitType type);
+    void QueueTransfer(Sect* to, ResourceId id, float amount);
+    Vector2 GetUnitSlotPosition(size_t slot, Vector2 center, float orbitRadius) const;
     void DrawTransparentRightPanel();
-    void DrawResourceStats(Vector2 position, float coreRadius);
+    void DrawResourceStats(Vector2 position, float coreRadius, const ResourceVector& resources);
 };
 
+template <typename Fn>
+size_t Sect::RemoveShipmentsIf(Fn fn) {
+    size_t kept = 0;
+    for (size_t i = 0; i < shipmentCount; i++) {
+        if (!fn(shipments[i])) {
+            shipments[kept++] = shipments[i];
+        }
+    }
+    shipmentCount = static_cast<uint8_t>(kept);
+    return kept;
+}
+
 #endif // SECT_H
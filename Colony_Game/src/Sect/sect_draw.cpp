@@ -0,0 +1,225 @@
+#include "sect.h"
+#include "profiler.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// Unit circles and orbit offsets for the colony view, computed once instead of per sect
+struct ColonyViewGeometry {
+    static const int CORE_SEGMENTS = 32;
+    static const int DOT_SEGMENTS = 8;
+
+    Vector2 indicatorOffsets[UNIT_TYPE_COUNT];  // In core radii
+    Vector2 coreCircle[CORE_SEGMENTS + 1];      // Last point repeats the first
+    Vector2 dotCircle[DOT_SEGMENTS + 1];
+
+    ColonyViewGeometry() {
+        // 8 units, 45 degrees apart starting at the top, 1.4 core radii out
+        for (size_t i = 0; i < UNIT_TYPE_COUNT; i++) {
+            float angle = (90.0f - (i * 45.0f)) * DEG2RAD;
+            indicatorOffsets[i] = {1.4f * cosf(angle), -1.4f * sinf(angle)};
+        }
+        for (int i = 0; i <= CORE_SEGMENTS; i++) {
+            float angle = 2.0f * PI * (i % CORE_SEGMENTS) / CORE_SEGMENTS;
+            coreCircle[i] = {cosf(angle), sinf(angle)};
+        }
+        for (int i = 0; i <= DOT_SEGMENTS; i++) {
+            float angle = 2.0f * PI * (i % DOT_SEGMENTS) / DOT_SEGMENTS;
+            dotCircle[i] = {cosf(angle), sinf(angle)};
+        }
+    }
+};
+
+static const ColonyViewGeometry geometry;
+
+// Vertices a single item can add to the batch, checked before each item
+static const int FULL_ITEM_VERTICES = 3 * ColonyViewGeometry::CORE_SEGMENTS +
+                                      3 * ColonyViewGeometry::DOT_SEGMENTS * UNIT_TYPE_COUNT +
+                                      6 * ColonyViewGeometry::CORE_SEGMENTS;
+static const int DOT_ITEM_VERTICES = 6;
+
+static void BatchColor(Color color) {
+    rlColor4ub(color.r, color.g, color.b, color.a);
+}
+
+// Filled circle as a triangle fan, wound like raylib's own shapes
+static void BatchCircle(Vector2 center, float radius, const Vector2* circle, int segments) {
+    for (int i = 0; i < segments; i++) {
+        rlVertex2f(center.x, center.y);
+        rlVertex2f(center.x + circle[i + 1].x * radius, center.y + circle[i + 1].y * radius);
+        rlVertex2f(center.x + circle[i].x * radius, center.y + circle[i].y * radius);
+    }
+}
+
+static void BatchRingSegment(Vector2 center, float innerRadius, float outerRadius, Vector2 from, Vector2 to) {
+    rlVertex2f(center.x + from.x * outerRadius, center.y + from.y * outerRadius);
+    rlVertex2f(center.x + from.x * innerRadius, center.y + from.y * innerRadius);
+    rlVertex2f(center.x + to.x * innerRadius, center.y + to.y * innerRadius);
+
+    rlVertex2f(center.x + from.x * outerRadius, center.y + from.y * outerRadius);
+    rlVertex2f(center.x + to.x * innerRadius, center.y + to.y * innerRadius);
+    rlVertex2f(center.x + to.x * outerRadius, center.y + to.y * outerRadius);
+}
+
+// Development arc clockwise from angle 0, whole table segments plus one partial segment
+static void BatchArc(Vector2 center, float innerRadius, float outerRadius, float fraction) {
+    const int segments = ColonyViewGeometry::CORE_SEGMENTS;
+    float covered = Clamp(fraction, 0.0f, 1.0f) * segments;
+    int whole = static_cast<int>(covered);
+
+    for (int i = 0; i < whole; i++) {
+        BatchRingSegment(center, innerRadius, outerRadius, geometry.coreCircle[i], geometry.coreCircle[i + 1]);
+    }
+    if (whole < segments && covered > whole) {
+        float angle = 2.0f * PI * covered / segments;
+        BatchRingSegment(center, innerRadius, outerRadius, geometry.coreCircle[whole], {cosf(angle), sinf(angle)});
+    }
+}
+
+void Sect::DrawColonyViewItems(const SectDrawItem* items, size_t count, SectDetail detail) {
+    if (count == 0 || detail == SectDetail::Colony) {
+        return;
+    }
+
+    // Everything goes into rlgl's vertex batch as plain triangles, which raylib
+    // uploads and draws once per frame instead of once per shape
+    rlBegin(RL_TRIANGLES);
+
+    for (size_t i = 0; i < count; i++) {
+        const SectDrawItem& item = items[i];
+        Vector2 pos = item.position;
+        float coreRadius = item.coreRadius;
+
+        if (detail == SectDetail::Dot) {
+            // Too small for indicators to be told apart: one quad the size of the core
+            rlCheckRenderBatchLimit(DOT_ITEM_VERTICES);
+            BatchColor(item.color);
+            rlVertex2f(pos.x - coreRadius, pos.y - coreRadius);
+            rlVertex2f(pos.x - coreRadius, pos.y + coreRadius);
+            rlVertex2f(pos.x + coreRadius, pos.y + coreRadius);
+            rlVertex2f(pos.x - coreRadius, pos.y - coreRadius);
+            rlVertex2f(pos.x + coreRadius, pos.y + coreRadius);
+            rlVertex2f(pos.x + coreRadius, pos.y - coreRadius);
+            continue;
+        }
+
+        // A full batch is drawn and restarted here, keeping the triangle mode
+        rlCheckRenderBatchLimit(FULL_ITEM_VERTICES);
+
+        // Main sect circle
+        BatchColor(item.color);
+        BatchCircle(pos, coreRadius, geometry.coreCircle, ColonyViewGeometry::CORE_SEGMENTS);
+
+        // Active units indicator as small dots around the sect, one per unit type
+        float indicatorRadius = coreRadius * 0.3f;
+        for (size_t unit = 0; unit < UNIT_TYPE_COUNT; unit++) {
+            Vector2 offset = geometry.indicatorOffsets[unit];
+            Vector2 indicatorPos = {pos.x + offset.x * coreRadius, pos.y + offset.y * coreRadius};
+            BatchColor((item.activeMask & (1u << unit)) ? GREEN : GRAY);
+            BatchCircle(indicatorPos, indicatorRadius, geometry.dotCircle, ColonyViewGeometry::DOT_SEGMENTS);
+        }
+
+        // Development percentage as a progress arc
+        if (item.development > 0) {
+            BatchColor(Fade(GREEN, 0.5f));
+            BatchArc(pos, coreRadius * 1.1f, coreRadius * 1.2f, item.development);
+        }
+    }
+
+    rlEnd();
+}
+
+void Sect::DrawInSectView(Vector2 position, const SectViewState& state) {
+    PROFILE_SCOPE("Sect::DrawInSectView");
+
+    float coreRadius = GetScreenHeight() * 0.3f;  // Core takes 60% of screen height
+
+    // Draw the main core circle
+    DrawCircle(position.x, position.y, coreRadius, LIGHTGRAY);
+    DrawCircleLines(position.x, position.y, coreRadius, BLACK);
+
+    // Draw core information
+    DrawText(TextFormat("Development: %.1f%%", state.development * 100),
+            position.x - MeasureText("Development: 100.0%", 20)/2,
+            position.y - 10,
+            20,
+            BLACK);
+
+    // Draw resource stats in the core
+    DrawResourceStats(position, coreRadius, state.resources);
+
+    // Draw the units around the core
+    float unitRadius = coreRadius * 0.2f;  // Units are 20% the size of core
+    float orbitRadius = coreRadius * 1.4f; // Distance from core to units
+
+    uint8_t activeMask = state.activeMask;
+
+    // Remember the layout for click detection
+    sectViewCenter = position;
+    sectViewCoreRadius = coreRadius;
+
+    for (size_t i = 0; i < UNIT_TYPE_COUNT; ++i) {
+        Vector2 unitPos = GetUnitSlotPosition(i, position, orbitRadius);
+
+        // Draw the unit circle (placeholders are inactive)
+        Color fillColor = (activeMask & (1u << i)) ? GREEN : GRAY;
+        DrawCircle(unitPos.x, unitPos.y, unitRadius, fillColor);
+        DrawCircleLines(unitPos.x, unitPos.y, unitRadius, BLACK);
+
+        // Draw first letter of unit type (only in Sect view)
+        char firstLetter[2] = {GetUnitTypeName(static_cast<UnitType>(i))[0], '\0'};
+
+        // Center the letter in the circle
+        int fontSize = (int)(unitRadius);
+        Vector2 textSize = MeasureTextEx(GetFontDefault(), firstLetter, fontSize, 1);
+        Vector2 textPos = {
+            unitPos.x - textSize.x/2,
+            unitPos.y - textSize.y/2
+        };
+
+        DrawText(firstLetter, textPos.x, textPos.y, fontSize, BLACK);
+    }
+
+    // Draw the transparent right panel
+    DrawTransparentRightPanel();
+}
+
+void Sect::DrawResourceStats(Vector2 position, float coreRadius, const ResourceVector& resources) {
+    // Draw production/consumption stats in the core
+    const float statsY = position.y - coreRadius * 0.5f;
+    const float statsSpacing = 25;
+    int statIndex = 0;
+
+    std::vector<std::pair<const char*, int>> stats = {
+        {"Energy: ", static_cast<int>(resources[Resource::Energy])},
+        {"Iron: ", static_cast<int>(resources[Resource::Iron])},
+        {"Food: ", static_cast<int>(resources[Resource::Food])},
+    };
+
+    for (const auto& stat : stats) {
+        const char* text = TextFormat("%s%d", stat.first, stat.second);
+        DrawText(text,
+                position.x - MeasureText(text, 20)/2,
+                statsY + statIndex * statsSpacing,
+                20,
+                BLACK);
+        statIndex++;
+    }
+}
+
+void Sect::DrawTransparentRightPanel() {
+    int panelWidth = 100;
+    Rectangle panel = {
+        (float)GetScreenWidth() - panelWidth,
+        0,
+        (float)panelWidth,
+        (float)GetScreenHeight()
+    };
+    DrawRectangleRec(panel, Fade(WHITE, 0.5f));
+
+    // Draw panel content (e.g., notifications, alerts)
+    DrawText("Updates",
+            GetScreenWidth() - panelWidth + 10,
+            10,
+            20,
+            BLACK);
+}
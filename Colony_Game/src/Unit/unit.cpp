@@ -1,147 +1,148 @@
 #include "unit.h"
-#include <iostream>
-#include <cmath>
-
-Unit::Unit(std::string type) : unit_type(type), status("inactive"), energy_cost(0) {
+#include "log.h"
+
+Unit::Unit(UnitType type)
+    : type(type),
+      storeHandle(UnitStore::INVALID_HANDLE),
+      status(UnitStatus::Inactive),
+      energy_cost(0)
+{
     SetInitialParameters();
+    storeHandle = UnitStore::Global().Add(type, CalculateRates());
 }
 
 Unit::~Unit() {
-    // Cleanup if necessary
+    UnitStore::Global().Remove(storeHandle);
 }
 
 void Unit::Start() {
-    status = "active";
-    std::cout << "Unit " << unit_type << " started." << std::endl;
+    SetStatus(UnitStatus::Active);
+    LOG_INFO("Unit %s started.", GetUnitType());
 }
 
 void Unit::Stop() {
-    status = "inactive";
-    std::cout << "Unit " << unit_type << " stopped." << std::endl;
+    SetStatus(UnitStatus::Inactive);
+    LOG_INFO("Unit %s stopped.", GetUnitType());
+}
+
+void Unit::SetStatus(UnitStatus newStatus) {
+    status = newStatus;
+    UnitStore::Global().SetActive(storeHandle, status == UnitStatus::Active);
 }
 
 void Unit::Upgrade(int level) {
     // TODO: Implement upgrade logic
-    std::cout << "Unit " << unit_type << " upgraded to level " << level << std::endl;
+    LOG_INFO("Unit %s upgraded to level %d", GetUnitType(), level);
 }
 
+// Per-unit views of the last UnitStore tick (the tick itself runs in UnitStore::Tick)
 std::map<std::string, float> Unit::CalculateConsumption() const {
-    // TODO: Implement consumption calculation
-    std::cout << "Unit " << unit_type << " consumption calculated." << std::endl;
+    const UnitStore& store = UnitStore::Global();
+    std::map<std::string, float> consumption;
+    consumption["Energy"] = store.GetEnergyConsumption(storeHandle);
+    consumption[ResourceRegistry::Global().GetName(GetUnitInputResource(type))] += store.GetMaterialConsumption(storeHandle);
+    LOG_DEBUG("Unit %s consumption calculated.", GetUnitType());
     return consumption;
 }
 
 std::map<std::string, float> Unit::CalculateProduction() const {
-    // TODO: Implement production calculation
-    std::cout << "Unit " << unit_type << " production calculated." << std::endl;
+    std::map<std::string, float> production;
+    production[ResourceRegistry::Global().GetName(GetUnitOutputResource(type))] = UnitStore::Global().GetProduction(storeHandle);
+    LOG_DEBUG("Unit %s production calculated.", GetUnitType());
     return production;
 }
 
 void Unit::DisplayStats() const {
-    std::cout << "Unit Type: " << unit_type << ", Status: " << status << std::endl;
-    for (const auto& param : parameters) {
-        std::cout << param.first << ": " << param.second << std::endl;
+    LOG_INFO("Unit Type: %s, Status: %s", GetUnitType(), GetUnitStatusName(status));
+    const UnitSchemaInfo& schema = UNIT_SCHEMAS[UnitTypeIndex(type)];
+    for (size_t i = 0; i < schema.count; i++) {
+        LOG_INFO("%s: %g", schema.names[i], parameters[i]);
     }
 }
 
 void Unit::Update() {
     // TODO: Implement unit update logic
-    std::cout << "Unit " << unit_type << " updated." << std::endl;
-}
-
-void Unit::DrawInSectView(Vector2 corePosition, float coreRadius, int index) {
-    float angle = (index * 45.0f) * DEG2RAD;  // 8 units evenly spaced (360/8 = 45 degrees)
-    float radius = coreRadius * 1.2f;  // Distance from the core
-
-    Vector2 unitPosition = {
-        corePosition.x + radius * cosf(angle),
-        corePosition.y + radius * sinf(angle)
-    };
-
-    // Draw the unit circle
-    bool isBuilt = (status == "active");
-    float unitRadius = 30;
-    DrawCircleV(unitPosition, unitRadius, isBuilt ? BLUE : BLANK);
-    DrawCircleLines(unitPosition.x, unitPosition.y, unitRadius, GREEN);
+    LOG_DEBUG("Unit %s updated.", GetUnitType());
 }
 
-void Unit::DrawInUnitView() {
-    // Left control panel (rectangle)
-    //Rectangle controlPanel = { 0, 0, 300, (float)GetScreenHeight() };
-    //DrawRectangleRec(controlPanel, GRAY);
-
-    // Right transparent panel
-    Rectangle transparentPanel = { (float)GetScreenWidth() - 300, 0, 300, (float)GetScreenHeight() };
-    DrawRectangleRec(transparentPanel, Fade(GRAY, 0.5f));
+// Maps the type specific parameters onto the common rates the UnitStore ticks
+UnitStore::Rates Unit::CalculateRates() const {
+    UnitStore::Rates rates = {0.0f, 1.0f, 0.0f, 0.0f};
+
+    switch (type) {
+        case UnitType::Extraction: {
+            typedef ExtractionParams P;
+            rates.outputRate = parameters[P::ExtractionRate];
+            rates.efficiency = parameters[P::Efficiency];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::WearAndTear];
+            break;
+        }
+        case UnitType::Farming: {
+            typedef FarmingParams P;
+            rates.outputRate = parameters[P::FoodProductionRate];
+            rates.efficiency = parameters[P::FertilityLevel] * parameters[P::GrowthBoost];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::WaterConsumption];
+            break;
+        }
+        case UnitType::Energy: {
+            typedef EnergyParams P;
+            rates.outputRate = parameters[P::EnergyOutput];
+            rates.efficiency = parameters[P::Efficiency] * (1.0f + parameters[P::WeatherImpact]);
+            rates.materialUse = parameters[P::FuelConsumption];
+            break;
+        }
+        case UnitType::Manufacture: {
+            typedef ManufactureParams P;
+            rates.outputRate = parameters[P::ProductionRate];
+            rates.efficiency = parameters[P::ProductionEfficiency];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::MaterialConsumption];
+            break;
+        }
+        case UnitType::Construction: {
+            typedef ConstructionParams P;
+            rates.outputRate = parameters[P::BuildSpeed];
+            rates.efficiency = parameters[P::RepairEfficiency];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::MaterialConsumption];
+            break;
+        }
+        case UnitType::Transport: {
+            typedef TransportParams P;
+            rates.outputRate = parameters[P::TransportCapacity];
+            rates.efficiency = parameters[P::Efficiency];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::FuelConsumption];
+            break;
+        }
+        case UnitType::Research: {
+            typedef ResearchParams P;
+            rates.outputRate = parameters[P::ResearchPointsPerTick];
+            rates.efficiency = parameters[P::ResearchSpeedMultiplier];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::RareMetalConsumption];
+            break;
+        }
+        case UnitType::Commerce: {
+            typedef CommerceParams P;
+            rates.outputRate = parameters[P::TradeCapacity];
+            rates.efficiency = parameters[P::TradeEfficiency] * parameters[P::ExchangeRate];
+            rates.energyUse = parameters[P::EnergyConsumption];
+            rates.materialUse = parameters[P::GoodsConsumption];
+            break;
+        }
+    }
 
-    // Draw additional UI elements inside the control panel (e.g., unit stats)
-    DrawText(("Unit Type: " + unit_type).c_str(), (float)GetScreenWidth() - 280, 10, 20, BLACK);
-    // Add more UI elements as needed
+    return rates;
 }
 
 void Unit::SetInitialParameters() {
-    if (unit_type == "Extraction") {
-        parameters["ExtractionRate"] = 10;
-        parameters["ResourceFocus"] = 1; // 1 could represent "Iron"
-        parameters["EnergyConsumption"] = 5;
-        parameters["WearAndTear"] = 0.2; // 1 Fe per 5 minutes
-        parameters["Efficiency"] = 0.8;
-        parameters["StorageCapacity"] = 100;
-        parameters["BreakdownChance"] = 0.02;
-    } else if (unit_type == "Farming") {
-        parameters["FoodProductionRate"] = 10;
-        parameters["WaterConsumption"] = 3;
-        parameters["EnergyConsumption"] = 2;
-        parameters["FertilityLevel"] = 0.75;
-        parameters["StorageCapacity"] = 200;
-        parameters["GrowthBoost"] = 1.1;
-        parameters["CropFocus"] = 1; // 1 could represent "Grain"
-    } else if (unit_type == "Energy") {
-        parameters["EnergyOutput"] = 15;
-        parameters["EnergySource"] = 1; // 1 could represent "Solar"
-        parameters["StorageCapacity"] = 500;
-        parameters["Efficiency"] = 0.9;
-        parameters["FuelConsumption"] = 2;
-        parameters["WeatherImpact"] = -0.2;
-        parameters["MaintenanceCost"] = 0.1; // 1 Fe per 10 minutes
-    } else if (unit_type == "Manufacture") {
-        parameters["ProductionRate"] = 1;
-        parameters["BlueprintsUnlocked"] = 1; // 1 could represent "Tools"
-        parameters["EnergyConsumption"] = 5;
-        parameters["MaterialConsumption"] = 5; // 3 Fe + 2 Si
-        parameters["ProductStorage"] = 100;
-        parameters["ProductionEfficiency"] = 0.85;
-        parameters["UpgradeEffect"] = 0.1;
-    } else if (unit_type == "Construction") {
-        parameters["BuildSpeed"] = 0.2; // 1 structure per 5 minutes
-        parameters["RepairEfficiency"] = 0.9;
-        parameters["EnergyConsumption"] = 4;
-        parameters["MaterialConsumption"] = 5;
-        parameters["MaintenanceCost"] = 0.2; // 2 Fe per 10 minutes
-        parameters["ConstructionRange"] = 2;
-    } else if (unit_type == "Transport") {
-        parameters["TransportCapacity"] = 50;
-        parameters["Speed"] = 10;
-        parameters["EnergyConsumption"] = 5;
-        parameters["FuelConsumption"] = 3;
-        parameters["Efficiency"] = 0.8;
-        parameters["RoadConstructionSpeed"] = 1.0/24; // 1 km per day
-        parameters["UpgradeEffect"] = 0.1;
-    } else if (unit_type == "Research") {
-        parameters["ResearchPointsPerTick"] = 5;
-        parameters["EnergyConsumption"] = 10;
-        parameters["RareMetalConsumption"] = 1;
-        parameters["FocusArea"] = 1; // 1 could represent "Manufacturing"
-        parameters["ResearchSpeedMultiplier"] = 1.0;
-        parameters["BreakthroughChance"] = 0.05;
-        parameters["UpgradeEffect"] = 0.2;
-    } else if (unit_type == "Commerce") {
-        parameters["TradeCapacity"] = 100;
-        parameters["ExchangeRate"] = 1;
-        parameters["EnergyConsumption"] = 3;
-        parameters["GoodsConsumption"] = 2;
-        parameters["TradeEfficiency"] = 0.9;
-        parameters["UpgradeEffect"] = 0.05;
+    // Defaults come from the compile-time schema in unit_schema.h
+    const UnitSchemaInfo& schema = UNIT_SCHEMAS[UnitTypeIndex(type)];
+    parameters.fill(0.0f);
+    for (size_t i = 0; i < schema.count; i++) {
+        parameters[i] = schema.defaults[i];
     }
 }
-
@@ -5,12 +5,21 @@
 #include <string>
 #include <map>
 #include <vector>
+#include <array>
+#include "unit_types.h"
+#include "unit_schema.h"
+#include "unit_store.h"
 
+// Like Sect, a unit owns nothing but its slot in the UnitStore
 class Unit {
 public:
-    Unit(std::string type);
+    explicit Unit(UnitType type);
     ~Unit();
 
+    // A unit owns its slot in the UnitStore
+    Unit(const Unit&) = delete;
+    Unit& operator=(const Unit&) = delete;
+
     void Start();
     void Stop();
     void Upgrade(int level);
@@ -23,27 +32,35 @@ public:
     void SetInitialParameters();
 
     // Getters
-    std::string GetStatus() const { return status; }
+    UnitStatus GetStatus() const { return status; }
+    bool IsActive() const { return status == UnitStatus::Active; }
     Vector2 GetUnitPosInSectView() const { return positionInSectView;}
     float GetUnitRadiusInSectView() const { return radiusInSectView;}
-    std::string GetUnitType() const { return unit_type;}
+    const char* GetUnitType() const { return GetUnitTypeName(type); }
+    UnitType GetType() const { return type; }
+    UnitStore::Handle GetStoreHandle() const { return storeHandle; }
+
+    // Parameters are indexed by the schema enum of the unit's type,
+    // e.g. unit->GetParameter(ExtractionParams::ExtractionRate)
+    float GetParameter(size_t index) const { return parameters[index]; }
+    size_t GetParameterCount() const { return UNIT_SCHEMAS[UnitTypeIndex(type)].count; }
 
     // Setters
     void SetUnitPosInSectView(Vector2 position) {positionInSectView = position;}
     void SetUnitRadiusInSectView(float radius) {radiusInSectView = radius;}
-    void SetStatus(const std::string& newStatus) { status = newStatus; }
+    void SetStatus(UnitStatus newStatus);
 
 
 private:
     Vector2 positionInSectView;
     float radiusInSectView;
-    std::string unit_type;
-    std::map<std::string, float> parameters;
-    std::map<std::string, float> consumption;
-    std::map<std::string, float> production;
-    std::string status;
-    std::vector<std::string> upgrades;
+    UnitType type;
+    UnitStore::Handle storeHandle;
+    std::array<float, MAX_UNIT_PARAMETERS> parameters;
+    UnitStatus status;
     float energy_cost;
+
+    UnitStore::Rates CalculateRates() const;
 };
 
 #endif // UNIT_H
@@ -0,0 +1,35 @@
+#include "unit.h"
+#include "profiler.h"
+#include <cmath>
+
+void Unit::DrawInSectView(Vector2 corePosition, float coreRadius, int index) {
+    float angle = (index * 45.0f) * DEG2RAD;  // 8 units evenly spaced (360/8 = 45 degrees)
+    float radius = coreRadius * 1.2f;  // Distance from the core
+
+    Vector2 unitPosition = {
+        corePosition.x + radius * cosf(angle),
+        corePosition.y + radius * sinf(angle)
+    };
+
+    // Draw the unit circle
+    bool isBuilt = IsActive();
+    float unitRadius = 30;
+    DrawCircleV(unitPosition, unitRadius, isBuilt ? BLUE : BLANK);
+    DrawCircleLines(unitPosition.x, unitPosition.y, unitRadius, GREEN);
+}
+
+void Unit::DrawInUnitView() {
+    PROFILE_SCOPE("Unit::DrawInUnitView");
+
+    // Left control panel (rectangle)
+    //Rectangle controlPanel = { 0, 0, 300, (float)GetScreenHeight() };
+    //DrawRectangleRec(controlPanel, GRAY);
+
+    // Right transparent panel
+    Rectangle transparentPanel = { (float)GetScreenWidth() - 300, 0, 300, (float)GetScreenHeight() };
+    DrawRectangleRec(transparentPanel, Fade(GRAY, 0.5f));
+
+    // Draw additional UI elements inside the control panel (e.g., unit stats)
+    DrawText(TextFormat("Unit Type: %s", GetUnitType()), (float)GetScreenWidth() - 280, 10, 20, BLACK);
+    // Add more UI elements as needed
+}
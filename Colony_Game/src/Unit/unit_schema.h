@@ -0,0 +1,157 @@
+#ifndef UNIT_SCHEMA_H
+#define UNIT_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "unit_types.h"
+
+// Parameter schema of every unit type, the single source of truth for
+// unit parameters. Each list entry is P(Name, Default).
+//
+// From these lists the header generates, per unit type, a struct such as
+// ExtractionParams with an Index enum (ExtractionParams::ExtractionRate),
+// the constexpr DEFAULTS and the NAMES used for display. Units store their
+// parameters in a fixed array indexed by that enum.
+
+#define EXTRACTION_PARAMETERS(P) \
+    P(ExtractionRate, 10.0f) \
+    P(ResourceFocus, 1.0f)          /* 1 could represent "Iron" */ \
+    P(EnergyConsumption, 5.0f) \
+    P(WearAndTear, 0.2f)            /* 1 Fe per 5 minutes */ \
+    P(Efficiency, 0.8f) \
+    P(StorageCapacity, 100.0f) \
+    P(BreakdownChance, 0.02f)
+
+#define FARMING_PARAMETERS(P) \
+    P(FoodProductionRate, 10.0f) \
+    P(WaterConsumption, 3.0f) \
+    P(EnergyConsumption, 2.0f) \
+    P(FertilityLevel, 0.75f) \
+    P(StorageCapacity, 200.0f) \
+    P(GrowthBoost, 1.1f) \
+    P(CropFocus, 1.0f)              /* 1 could represent "Grain" */
+
+#define ENERGY_PARAMETERS(P) \
+    P(EnergyOutput, 15.0f) \
+    P(EnergySource, 1.0f)           /* 1 could represent "Solar" */ \
+    P(StorageCapacity, 500.0f) \
+    P(Efficiency, 0.9f) \
+    P(FuelConsumption, 2.0f) \
+    P(WeatherImpact, -0.2f) \
+    P(MaintenanceCost, 0.1f)        /* 1 Fe per 10 minutes */
+
+#define MANUFACTURE_PARAMETERS(P) \
+    P(ProductionRate, 1.0f) \
+    P(BlueprintsUnlocked, 1.0f)     /* 1 could represent "Tools" */ \
+    P(EnergyConsumption, 5.0f) \
+    P(MaterialConsumption, 5.0f)    /* 3 Fe + 2 Si */ \
+    P(ProductStorage, 100.0f) \
+    P(ProductionEfficiency, 0.85f) \
+    P(UpgradeEffect, 0.1f)
+
+#define CONSTRUCTION_PARAMETERS(P) \
+    P(BuildSpeed, 0.2f)             /* 1 structure per 5 minutes */ \
+    P(RepairEfficiency, 0.9f) \
+    P(EnergyConsumption, 4.0f) \
+    P(MaterialConsumption, 5.0f) \
+    P(MaintenanceCost, 0.2f)        /* 2 Fe per 10 minutes */ \
+    P(ConstructionRange, 2.0f)
+
+#define TRANSPORT_PARAMETERS(P) \
+    P(TransportCapacity, 50.0f) \
+    P(Speed, 10.0f) \
+    P(EnergyConsumption, 5.0f) \
+    P(FuelConsumption, 3.0f) \
+    P(Efficiency, 0.8f) \
+    P(RoadConstructionSpeed, 1.0f / 24.0f)  /* 1 km per day */ \
+    P(UpgradeEffect, 0.1f)
+
+#define RESEARCH_PARAMETERS(P) \
+    P(ResearchPointsPerTick, 5.0f) \
+    P(EnergyConsumption, 10.0f) \
+    P(RareMetalConsumption, 1.0f) \
+    P(FocusArea, 1.0f)              /* 1 could represent "Manufacturing" */ \
+    P(ResearchSpeedMultiplier, 1.0f) \
+    P(BreakthroughChance, 0.05f) \
+    P(UpgradeEffect, 0.2f)
+
+#define COMMERCE_PARAMETERS(P) \
+    P(TradeCapacity, 100.0f) \
+    P(ExchangeRate, 1.0f) \
+    P(EnergyConsumption, 3.0f) \
+    P(GoodsConsumption, 2.0f) \
+    P(TradeEfficiency, 0.9f) \
+    P(UpgradeEffect, 0.05f)
+
+// All unit types in UnitType order: X(Type, PARAMETER_LIST)
+#define UNIT_SCHEMA(X) \
+    X(Extraction, EXTRACTION_PARAMETERS) \
+    X(Farming, FARMING_PARAMETERS) \
+    X(Energy, ENERGY_PARAMETERS) \
+    X(Manufacture, MANUFACTURE_PARAMETERS) \
+    X(Construction, CONSTRUCTION_PARAMETERS) \
+    X(Transport, TRANSPORT_PARAMETERS) \
+    X(Research, RESEARCH_PARAMETERS) \
+    X(Commerce, COMMERCE_PARAMETERS)
+
+#define UNIT_PARAM_INDEX(name, value) name,
+#define UNIT_PARAM_DEFAULT(name, value) value,
+#define UNIT_PARAM_NAME(name, value) #name,
+
+#define UNIT_SCHEMA_STRUCT(type, PARAMETERS) \
+    struct type##Params { \
+        enum Index : uint8_t { PARAMETERS(UNIT_PARAM_INDEX) COUNT }; \
+        static constexpr UnitType TYPE = UnitType::type; \
+        static constexpr float DEFAULTS[COUNT] = { PARAMETERS(UNIT_PARAM_DEFAULT) }; \
+        static constexpr const char* NAMES[COUNT] = { PARAMETERS(UNIT_PARAM_NAME) }; \
+    };
+
+UNIT_SCHEMA(UNIT_SCHEMA_STRUCT)
+
+#undef UNIT_SCHEMA_STRUCT
+
+// Runtime view of the schema, indexed by UnitType
+struct UnitSchemaInfo {
+    size_t count;
+    const float* defaults;
+    const char* const* names;
+};
+
+#define UNIT_SCHEMA_INFO(type, PARAMETERS) \
+    { type##Params::COUNT, type##Params::DEFAULTS, type##Params::NAMES },
+
+constexpr UnitSchemaInfo UNIT_SCHEMAS[] = { UNIT_SCHEMA(UNIT_SCHEMA_INFO) };
+
+#undef UNIT_SCHEMA_INFO
+
+static_assert(sizeof(UNIT_SCHEMAS) / sizeof(UNIT_SCHEMAS[0]) == UNIT_TYPE_COUNT,
+              "UNIT_SCHEMA must list every unit type");
+
+#define UNIT_SCHEMA_TYPE(type, PARAMETERS) type##Params::TYPE,
+
+constexpr bool UnitSchemaFollowsTypeOrder() {
+    const UnitType types[] = { UNIT_SCHEMA(UNIT_SCHEMA_TYPE) };
+    for (size_t i = 0; i < UNIT_TYPE_COUNT; i++) {
+        if (UnitTypeIndex(types[i]) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#undef UNIT_SCHEMA_TYPE
+
+static_assert(UnitSchemaFollowsTypeOrder(), "UNIT_SCHEMA must follow UnitType order");
+
+// Largest parameter count of any unit type, the size of a unit's parameter array
+constexpr size_t MaxUnitParameterCount() {
+    size_t result = 0;
+    for (const auto& schema : UNIT_SCHEMAS) {
+        result = schema.count > result ? schema.count : result;
+    }
+    return result;
+}
+
+const size_t MAX_UNIT_PARAMETERS = MaxUnitParameterCount();
+
+#endif // UNIT_SCHEMA_H
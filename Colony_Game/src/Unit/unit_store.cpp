@@ -0,0 +1,311 @@
+#include "unit_store.h"
+#include "profiler.h"
+#include "job_system.h"
+#include <algorithm>
+
+void UnitStore::SectSet::Insert(uint32_t sectId) {
+    size_t word = sectId / 64;
+    if (word >= words.size()) {
+        words.resize(word + 1, 0);
+    }
+    words[word] |= uint64_t(1) << (sectId % 64);
+}
+
+void UnitStore::SectSet::Erase(uint32_t sectId) {
+    size_t word = sectId / 64;
+    if (word < words.size()) {
+        words[word] &= ~(uint64_t(1) << (sectId % 64));
+    }
+}
+
+bool UnitStore::SectSet::Contains(uint32_t sectId) const {
+    size_t word = sectId / 64;
+    return word < words.size() && (words[word] >> (sectId % 64)) & 1;
+}
+
+size_t UnitStore::SectSet::Count() const {
+    size_t count = 0;
+    for (uint64_t word : words) {
+        count += __builtin_popcountll(word);
+    }
+    return count;
+}
+
+size_t UnitStore::SectSet::CountIntersection(const SectSet& other) const {
+    size_t count = 0;
+    size_t n = std::min(words.size(), other.words.size());
+    for (size_t i = 0; i < n; i++) {
+        count += __builtin_popcountll(words[i] & other.words[i]);
+    }
+    return count;
+}
+
+void UnitStore::SectSet::EraseAll(const SectSet& other) {
+    size_t n = std::min(words.size(), other.words.size());
+    for (size_t i = 0; i < n; i++) {
+        words[i] &= ~other.words[i];
+    }
+}
+
+UnitStore& UnitStore::Global() {
+    static UnitStore store;
+    return store;
+}
+
+UnitStore::Handle UnitStore::Add(UnitType type, const Rates& rates) {
+    Lane& lane = lanes[UnitTypeIndex(type)];
+
+    Handle handle;
+    if (freeHandle != INVALID_HANDLE) {
+        handle = freeHandle;
+        freeHandle = slots[handle].index;
+    } else {
+        handle = static_cast<Handle>(slots.size());
+        slots.push_back(Slot());
+    }
+    slots[handle].type = type;
+    slots[handle].index = static_cast<uint32_t>(lane.owner.size());
+
+    lane.owner.push_back(handle);
+    lane.sect.push_back(NO_SECT);
+    lane.active.push_back(0.0f);
+    lane.outputRate.push_back(rates.outputRate);
+    lane.efficiency.push_back(rates.efficiency);
+    lane.energyUse.push_back(rates.energyUse);
+    lane.materialUse.push_back(rates.materialUse);
+    lane.production.push_back(0.0f);
+    lane.energyConsumption.push_back(0.0f);
+    lane.materialConsumption.push_back(0.0f);
+
+    return handle;
+}
+
+void UnitStore::Remove(Handle handle) {
+    Slot& slot = slots[handle];
+    Lane& lane = lanes[UnitTypeIndex(slot.type)];
+    uint32_t index = slot.index;
+
+    if (lane.sect[index] != NO_SECT) {
+        UpdateStatusBits(slot.type, lane.sect[index], false);
+    }
+    uint32_t last = static_cast<uint32_t>(lane.owner.size() - 1);
+
+    // Move the last unit of the lane into the hole to keep the arrays dense
+    if (index != last) {
+        MoveUnit(lane, last, index);
+    }
+    ResizeLane(lane, last);
+
+    slot.index = freeHandle;
+    freeHandle = handle;
+}
+
+void UnitStore::MoveUnit(Lane& lane, uint32_t from, uint32_t to) {
+    lane.owner[to] = lane.owner[from];
+    lane.sect[to] = lane.sect[from];
+    lane.active[to] = lane.active[from];
+    lane.outputRate[to] = lane.outputRate[from];
+    lane.efficiency[to] = lane.efficiency[from];
+    lane.energyUse[to] = lane.energyUse[from];
+    lane.materialUse[to] = lane.materialUse[from];
+    lane.production[to] = lane.production[from];
+    lane.energyConsumption[to] = lane.energyConsumption[from];
+    lane.materialConsumption[to] = lane.materialConsumption[from];
+    slots[lane.owner[to]].index = to;
+}
+
+void UnitStore::ResizeLane(Lane& lane, size_t size) {
+    lane.owner.resize(size);
+    lane.sect.resize(size);
+    lane.active.resize(size);
+    lane.outputRate.resize(size);
+    lane.efficiency.resize(size);
+    lane.energyUse.resize(size);
+    lane.materialUse.resize(size);
+    lane.production.resize(size);
+    lane.energyConsumption.resize(size);
+    lane.materialConsumption.resize(size);
+}
+
+void UnitStore::SetActive(Handle handle, bool active) {
+    const Slot& slot = slots[handle];
+    Lane& lane = lanes[UnitTypeIndex(slot.type)];
+    lane.active[slot.index] = active ? 1.0f : 0.0f;
+
+    if (lane.sect[slot.index] != NO_SECT) {
+        UpdateStatusBits(slot.type, lane.sect[slot.index], active);
+    }
+}
+
+void UnitStore::SetSect(Handle handle, uint32_t sectId) {
+    const Slot& slot = slots[handle];
+    Lane& lane = lanes[UnitTypeIndex(slot.type)];
+    bool active = lane.active[slot.index] != 0.0f;
+
+    if (lane.sect[slot.index] != NO_SECT) {
+        UpdateStatusBits(slot.type, lane.sect[slot.index], false);
+    }
+    lane.sect[slot.index] = sectId;
+    if (sectId != NO_SECT) {
+        UpdateStatusBits(slot.type, sectId, active);
+    }
+}
+
+// A unit leaving its sect leaves an inactive placeholder behind, so the
+// present bit is never cleared here
+void UnitStore::UpdateStatusBits(UnitType type, uint32_t sectId, bool active) {
+    uint8_t bit = UnitTypeBit(type);
+    presentMasks[sectId] |= bit;
+    activeMasks[sectId] = active ? (activeMasks[sectId] | bit) : (activeMasks[sectId] & ~bit);
+
+    if (active) {
+        activeSects[UnitTypeIndex(type)].Insert(sectId);
+    } else {
+        activeSects[UnitTypeIndex(type)].Erase(sectId);
+    }
+}
+
+void UnitStore::SetRates(Handle handle, const Rates& rates) {
+    const Slot& slot = slots[handle];
+    Lane& lane = lanes[UnitTypeIndex(slot.type)];
+    lane.outputRate[slot.index] = rates.outputRate;
+    lane.efficiency[slot.index] = rates.efficiency;
+    lane.energyUse[slot.index] = rates.energyUse;
+    lane.materialUse[slot.index] = rates.materialUse;
+}
+
+uint32_t UnitStore::AddSect() {
+    uint32_t sectId;
+    if (!freeSects.empty()) {
+        sectId = freeSects.back();
+        freeSects.pop_back();
+    } else {
+        sectId = static_cast<uint32_t>(ledgers.size());
+        ledgers.push_back(SectLedger());
+        presentMasks.push_back(0);
+        activeMasks.push_back(0);
+    }
+    ledgers[sectId] = SectLedger();
+    return sectId;
+}
+
+void UnitStore::RemoveSect(uint32_t sectId) {
+    // Units must have left the sect already
+    ledgers[sectId] = SectLedger();
+    presentMasks[sectId] = 0;
+    activeMasks[sectId] = 0;
+    for (auto& sects : activeSects) {
+        sects.Erase(sectId);
+    }
+    freeSects.push_back(sectId);
+}
+
+void UnitStore::RemoveSects(const SectSet& sects) {
+    // Each lane is compacted in place, keeping the order of the units that stay
+    for (Lane& lane : lanes) {
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < lane.owner.size(); i++) {
+            if (lane.sect[i] != NO_SECT && sects.Contains(lane.sect[i])) {
+                slots[lane.owner[i]].index = freeHandle;
+                freeHandle = lane.owner[i];
+                continue;
+            }
+            if (kept != i) {
+                MoveUnit(lane, i, kept);
+            }
+            kept++;
+        }
+        ResizeLane(lane, kept);
+    }
+
+    for (auto& active : activeSects) {
+        active.EraseAll(sects);
+    }
+    sects.ForEach([this](uint32_t sectId) {
+        ledgers[sectId] = SectLedger();
+        presentMasks[sectId] = 0;
+        activeMasks[sectId] = 0;
+        freeSects.push_back(sectId);
+    });
+}
+
+size_t UnitStore::CountActiveUnits(UnitType type, const SectSet& sects) const {
+    return activeSects[UnitTypeIndex(type)].CountIntersection(sects);
+}
+
+void UnitStore::Tick() {
+    PROFILE_SCOPE("UnitStore::Tick");
+
+    JobSystem& jobs = JobSystem::Global();
+
+    jobs.ParallelFor(ledgers.size(), TICK_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            ledgers[i].produced.Clear();
+            ledgers[i].consumed.Clear();
+        }
+    });
+
+    // Lanes run one after another so every ledger sums its units in the same
+    // order. Within a lane a sect has at most one unit, so chunks of a lane
+    // never write the same ledger.
+    for (size_t t = 0; t < UNIT_TYPE_COUNT; t++) {
+        Lane& lane = lanes[t];
+        const UnitType type = static_cast<UnitType>(t);
+        const ResourceId output = GetUnitOutputResource(type);
+        const ResourceId input = GetUnitInputResource(type);
+
+        jobs.ParallelFor(lane.owner.size(), TICK_GRAIN, [&](size_t begin, size_t end) {
+            // Production and consumption of the chunk. Inactive units have
+            // active == 0, so the loop has no branches and vectorizes.
+            const float* __restrict active = lane.active.data();
+            const float* __restrict outputRate = lane.outputRate.data();
+            const float* __restrict efficiency = lane.efficiency.data();
+            const float* __restrict energyUse = lane.energyUse.data();
+            const float* __restrict materialUse = lane.materialUse.data();
+            float* __restrict production = lane.production.data();
+            float* __restrict energyConsumption = lane.energyConsumption.data();
+            float* __restrict materialConsumption = lane.materialConsumption.data();
+
+            for (size_t i = begin; i < end; i++) {
+                production[i] = active[i] * outputRate[i] * efficiency[i];
+                energyConsumption[i] = active[i] * energyUse[i];
+                materialConsumption[i] = active[i] * materialUse[i];
+            }
+
+            // Sum the results into the owning sects
+            const uint32_t* sect = lane.sect.data();
+            for (size_t i = begin; i < end; i++) {
+                if (sect[i] == NO_SECT) {
+                    continue;
+                }
+                SectLedger& ledger = ledgers[sect[i]];
+                ledger.produced[output] += production[i];
+                ledger.consumed[input] += materialConsumption[i];
+                ledger.consumed[Resource::Energy] += energyConsumption[i];
+            }
+        });
+    }
+}
+
+float UnitStore::GetProduction(Handle handle) const {
+    const Slot& slot = slots[handle];
+    return lanes[UnitTypeIndex(slot.type)].production[slot.index];
+}
+
+float UnitStore::GetEnergyConsumption(Handle handle) const {
+    const Slot& slot = slots[handle];
+    return lanes[UnitTypeIndex(slot.type)].energyConsumption[slot.index];
+}
+
+float UnitStore::GetMaterialConsumption(Handle handle) const {
+    const Slot& slot = slots[handle];
+    return lanes[UnitTypeIndex(slot.type)].materialConsumption[slot.index];
+}
+
+size_t UnitStore::GetUnitCount() const {
+    size_t count = 0;
+    for (const auto& lane : lanes) {
+        count += lane.owner.size();
+    }
+    return count;
+}
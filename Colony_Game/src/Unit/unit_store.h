@@ -0,0 +1,134 @@
+#ifndef UNIT_STORE_H
+#define UNIT_STORE_H
+
+#include <vector>
+#include <cstdint>
+#include "unit_types.h"
+
+// Struct-of-arrays storage for every unit on the planet.
+//
+// Units are grouped into one lane per unit type, and each lane keeps its
+// fields in parallel contiguous arrays. Tick() runs the economy for all
+// units in one pass over those arrays and sums the results per sect, so
+// the tick never touches Unit or Sect objects.
+//
+// The store also tracks unit status per sect: a byte mask per sect with one
+// bit per unit type, and per unit type a bitset over sect ids. Each sect
+// holds at most one unit of each type, so counting active units is a
+// popcount over those bitsets.
+class UnitStore {
+public:
+    typedef uint32_t Handle;  // Stable across removals of other units
+    static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+    // Bitset over sect ids
+    class SectSet {
+    public:
+        void Insert(uint32_t sectId);
+        void Erase(uint32_t sectId);
+        bool Contains(uint32_t sectId) const;
+        size_t Count() const;
+        size_t CountIntersection(const SectSet& other) const;
+        void EraseAll(const SectSet& other);  // Removes every id in other
+
+        // Visits the ids in increasing order
+        template <typename Fn>
+        void ForEach(Fn fn) const {
+            for (size_t i = 0; i < words.size(); i++) {
+                for (uint64_t word = words[i]; word != 0; word &= word - 1) {
+                    fn(static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+                }
+            }
+        }
+
+    private:
+        std::vector<uint64_t> words;
+    };
+
+    // Per-tick economy of one unit at full activity
+    struct Rates {
+        float outputRate;   // Units of the output resource per tick
+        float efficiency;   // Multiplier on outputRate
+        float energyUse;    // Energy consumed per tick
+        float materialUse;  // Input material consumed per tick
+    };
+
+    // Totals of one sect's units for the last tick
+    struct SectLedger {
+        ResourceVector produced;
+        ResourceVector consumed;
+    };
+
+    static UnitStore& Global();
+
+    Handle Add(UnitType type, const Rates& rates);
+    void Remove(Handle handle);
+    void SetActive(Handle handle, bool active);
+    void SetSect(Handle handle, uint32_t sectId);
+    void SetRates(Handle handle, const Rates& rates);
+
+    uint32_t AddSect();
+    void RemoveSect(uint32_t sectId);
+    // Drops the sects and every unit they hold in one pass per lane, for a
+    // colony going away as a whole. The Unit and Sect objects are left to
+    // their owner, who must not destroy them one by one afterwards.
+    void RemoveSects(const SectSet& sects);
+    void AddPlaceholders(uint32_t sectId, uint8_t typeMask) { presentMasks[sectId] |= typeMask; }
+
+    // Unit status queries
+    uint8_t GetActiveMask(uint32_t sectId) const { return activeMasks[sectId]; }
+    uint8_t GetInactiveMask(uint32_t sectId) const { return presentMasks[sectId] & ~activeMasks[sectId]; }
+    size_t CountActiveUnits(UnitType type) const { return activeSects[UnitTypeIndex(type)].Count(); }
+    size_t CountActiveUnits(UnitType type, const SectSet& sects) const;
+
+    // Runs production and consumption for every unit
+    void Tick();
+
+    // Results of the last Tick()
+    float GetProduction(Handle handle) const;
+    float GetEnergyConsumption(Handle handle) const;
+    float GetMaterialConsumption(Handle handle) const;
+    const SectLedger& GetSectLedger(uint32_t sectId) const { return ledgers[sectId]; }
+
+    size_t GetUnitCount() const;
+    size_t GetUnitCount(UnitType type) const { return lanes[UnitTypeIndex(type)].owner.size(); }
+
+private:
+    // All units of one type, one array per field
+    struct Lane {
+        std::vector<Handle> owner;        // Handle of the unit in each slot
+        std::vector<uint32_t> sect;       // Owning sect id
+        std::vector<float> active;        // 1 for active units, 0 otherwise
+        std::vector<float> outputRate;
+        std::vector<float> efficiency;
+        std::vector<float> energyUse;
+        std::vector<float> materialUse;
+        std::vector<float> production;          // Last tick results
+        std::vector<float> energyConsumption;
+        std::vector<float> materialConsumption;
+    };
+
+    struct Slot {
+        UnitType type;
+        uint32_t index;  // Position in the lane, or the next free handle when unused
+    };
+
+    Lane lanes[UNIT_TYPE_COUNT];
+    std::vector<Slot> slots;  // Indexed by handle
+    Handle freeHandle = INVALID_HANDLE;
+
+    std::vector<SectLedger> ledgers;  // Indexed by sect id
+    std::vector<uint8_t> presentMasks;  // Unit types each sect holds, as units or placeholders
+    std::vector<uint8_t> activeMasks;   // Unit types active in each sect
+    SectSet activeSects[UNIT_TYPE_COUNT];
+    std::vector<uint32_t> freeSects;
+
+    void UpdateStatusBits(UnitType type, uint32_t sectId, bool active);
+    void MoveUnit(Lane& lane, uint32_t from, uint32_t to);  // Overwrites the unit at to
+    static void ResizeLane(Lane& lane, size_t size);
+
+    static constexpr uint32_t NO_SECT = 0xFFFFFFFFu;
+    static constexpr size_t TICK_GRAIN = 4096;  // Units or ledgers per parallel job
+};
+
+#endif // UNIT_STORE_H
@@ -0,0 +1,75 @@
+#ifndef UNIT_TYPES_H
+#define UNIT_TYPES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "resource.h"
+
+// Unit types, in the order every sect lays them out around its core
+enum class UnitType : uint8_t {
+    Extraction,
+    Farming,
+    Energy,
+    Manufacture,
+    Construction,
+    Transport,
+    Research,
+    Commerce
+};
+
+const size_t UNIT_TYPE_COUNT = 8;
+
+constexpr size_t UnitTypeIndex(UnitType type) { return static_cast<size_t>(type); }
+
+// Bit of a unit type in per-sect unit masks
+constexpr uint8_t UnitTypeBit(UnitType type) { return static_cast<uint8_t>(1u << UnitTypeIndex(type)); }
+const uint8_t ALL_UNIT_TYPES_MASK = 0xFF;
+
+enum class UnitStatus : uint8_t {
+    Inactive,
+    Active
+};
+
+inline const char* GetUnitStatusName(UnitStatus status) {
+    return status == UnitStatus::Active ? "active" : "inactive";
+}
+
+inline const char* GetUnitTypeName(UnitType type) {
+    static const char* names[UNIT_TYPE_COUNT] = {
+        "Extraction", "Farming", "Energy", "Manufacture",
+        "Construction", "Transport", "Research", "Commerce"
+    };
+    return names[UnitTypeIndex(type)];
+}
+
+// Resource each unit type produces
+inline ResourceId GetUnitOutputResource(UnitType type) {
+    static const ResourceId outputs[UNIT_TYPE_COUNT] = {
+        Resource::Iron, Resource::Food, Resource::Energy, Resource::Tools,
+        Resource::Structures, Resource::Cargo, Resource::Research, Resource::Credits
+    };
+    return outputs[UnitTypeIndex(type)];
+}
+
+// Material each unit type consumes besides energy
+inline ResourceId GetUnitInputResource(UnitType type) {
+    static const ResourceId inputs[UNIT_TYPE_COUNT] = {
+        Resource::Iron, Resource::Water, Resource::Fuel, Resource::Iron,
+        Resource::Iron, Resource::Fuel, Resource::RareMetal, Resource::Tools
+    };
+    return inputs[UnitTypeIndex(type)];
+}
+
+// Interns a unit type name, returns false if the name is not a known unit type
+inline bool ParseUnitType(const std::string& name, UnitType& type) {
+    for (size_t i = 0; i < UNIT_TYPE_COUNT; i++) {
+        if (name == GetUnitTypeName(static_cast<UnitType>(i))) {
+            type = static_cast<UnitType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // UNIT_TYPES_H
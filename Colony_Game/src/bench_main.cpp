@@ -0,0 +1,348 @@
+#include "Colony/colony.h"
+#include "Planet/planet.h"
+#include "profiler.h"
+#include "job_system.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+// Every heap allocation in the process goes through these, so a benchmark can
+// report allocations per operation
+static std::atomic<size_t> allocationCount(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// Runs op in growing batches until minSeconds have passed and prints ns/op and allocs/op
+static void Benchmark(const char* name, double minSeconds, const std::function<void()>& op) {
+    op();  // Warm up caches and let lazy buffers reach their steady size
+
+    long iterations = 0;
+    long batch = 1;
+    size_t allocations = 0;
+    double seconds = 0.0;
+
+    while (seconds < minSeconds) {
+        size_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < batch; i++) {
+            op();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        seconds += elapsed.count();
+        allocations += allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        iterations += batch;
+        batch *= 2;
+    }
+
+    std::printf("  %-32s %14.1f ns/op %10.2f allocs/op %10ld ops\n",
+                name,
+                seconds * 1.0e9 / iterations,
+                static_cast<double>(allocations) / iterations,
+                iterations);
+}
+
+// Grid cell size of the world, one sect per cell (see Engine::PopulateWorld)
+static const float CELL_SIZE = PlanetConfig().cellSize;
+
+// A synthetic planet: colonies laid out as square blocks of grid cells, one sect per cell
+struct World {
+    std::vector<Colony*> colonies;
+    Planet planet;
+
+    World(int colonyCount, int sectsPerColony) {
+        int colonySide = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(sectsPerColony))));
+        int coloniesPerRow = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(colonyCount))));
+
+        for (int c = 0; c < colonyCount; c++) {
+            Colony* colony = new Colony(planet.GetConfig().GetSectRadius());
+            colony->ReserveSects(sectsPerColony);
+            colonies.push_back(colony);
+
+            int originX = (c % coloniesPerRow) * (colonySide + 1);
+            int originY = (c / coloniesPerRow) * (colonySide + 1);
+
+            for (int s = 0; s < sectsPerColony; s++) {
+                colony->AddSect({
+                    (originX + s % colonySide + 0.5f) * CELL_SIZE,
+                    (originY + s / colonySide + 0.5f) * CELL_SIZE
+                });
+            }
+
+            // Iron shipped down a road along each row, as in Engine::PopulateWorld
+            const std::vector<Sect*>& sects = colony->GetSects();
+            for (int s = 0; s + 1 < sectsPerColony; s++) {
+                if ((s + 1) % colonySide != 0) {
+                    colony->BuildRoad(sects[s], sects[s + 1]);
+                }
+            }
+            for (int s = 0; s + 1 < sectsPerColony; s++) {
+                if ((s + 1) % colonySide != 0) {
+                    colony->AddShipment(sects[s], sects[s + 1], Resource::Iron, 1.0f);
+                }
+            }
+        }
+    }
+
+    ~World() {
+        for (auto colony : colonies) {
+            delete colony;
+        }
+    }
+};
+
+static void RunSuite(int sectCount, double minSeconds) {
+    const int colonyCount = 10;
+    World world(colonyCount, sectCount / colonyCount);
+    std::printf("%d sects in %d colonies\n", sectCount, colonyCount);
+
+    Benchmark("Colony::CalculateCentroid", minSeconds, [&]() {
+        world.colonies[0]->CalculateCentroid();
+    });
+
+    // Nudges one interior sect back and forth; the centroid and radius follow incrementally
+    Colony* moved = world.colonies[0];
+    Sect* nudged = moved->GetSects()[moved->GetSects().size() / 2];
+    Vector2 home = nudged->GetPosition();
+    bool away = false;
+    Benchmark("Colony::MoveSect", minSeconds, [&]() {
+        away = !away;
+        moved->MoveSect(nudged, {home.x + (away ? 10.0f : 0.0f), home.y});
+    });
+
+    Benchmark("Planet::UpdateActiveArea", minSeconds, [&]() {
+        world.planet.UpdateActiveArea(world.colonies);
+    });
+
+    // Picks cycle through positions spread over the colony, hits and misses alike
+    Colony* picked = world.colonies[0];
+    Vector2 centroid = picked->GetCentroid();
+    float spread = std::sqrt(static_cast<float>(picked->GetSects().size())) * CELL_SIZE;
+    unsigned pick = 0;
+    Benchmark("Colony::FindSectAt", minSeconds, [&]() {
+        pick = pick * 1664525u + 1013904223u;
+        Vector2 position = {
+            centroid.x + ((pick >> 8) % 1024 / 1024.0f - 0.5f) * spread,
+            centroid.y + ((pick >> 18) % 1024 / 1024.0f - 0.5f) * spread
+        };
+        volatile Sect* sect = picked->FindSectAt(position);
+        (void)sect;
+    });
+
+    // Sects within a few cells of a point, into a reused buffer
+    std::vector<Sect*> nearby;
+    Benchmark("Colony::FindSectsInRadius", minSeconds, [&]() {
+        pick = pick * 1664525u + 1013904223u;
+        Vector2 position = {
+            centroid.x + ((pick >> 8) % 1024 / 1024.0f - 0.5f) * spread,
+            centroid.y + ((pick >> 18) % 1024 / 1024.0f - 0.5f) * spread
+        };
+        nearby.clear();
+        picked->FindSectsInRadius(position, 3.0f * CELL_SIZE, nearby);
+    });
+
+    // The same phases as Engine::Tick, on one thread and on the whole pool
+    std::vector<size_t> workerCounts = {0};
+    if (JobSystem::GetDefaultWorkerCount() > 0) {
+        workerCounts.push_back(JobSystem::GetDefaultWorkerCount());
+    }
+    for (size_t workers : workerCounts) {
+        JobSystem::Global().SetWorkerCount(workers);
+        Benchmark(workers == 0 ? "Production tick, 1 thread" : "Production tick, all threads", minSeconds, [&]() {
+            UnitStore::Global().Tick();
+            JobSystem::Global().ParallelFor(world.colonies.size(), 1, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; i++) {
+                    world.colonies[i]->Update();
+                }
+            });
+            for (auto& colony : world.colonies) {
+                colony->ApplyTransfers();
+                colony->ManageResources();
+            }
+        });
+    }
+
+    // Roads to each sect's right and lower neighbour in the colony's square block (the row roads exist already)
+    Colony* roaded = world.colonies[1];
+    const std::vector<Sect*>& roadSects = roaded->GetSects();
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<float>(roadSects.size()))));
+    for (size_t s = 0; s < roadSects.size(); s++) {
+        if ((s + 1) % side != 0 && s + 1 < roadSects.size()) {
+            roaded->BuildRoad(roadSects[s], roadSects[s + 1]);
+        }
+        if (s + side < roadSects.size()) {
+            roaded->BuildRoad(roadSects[s], roadSects[s + side]);
+        }
+    }
+    TransportNetwork& network = roaded->GetTransportNetwork();
+
+    // Shipments between 64 depots reuse cached routes; fresh pairs search the whole grid
+    unsigned shipment = 0;
+    auto depot = [&](unsigned value) { return roadSects[value % 64 * (roadSects.size() / 64)]->GetStoreId(); };
+    for (unsigned from = 0; from < 64; from++) {
+        for (unsigned to = 0; to < 64; to++) {
+            network.FindRoute(depot(from), depot(to));
+        }
+    }
+    Benchmark("TransportNetwork::FindRoute, cached", minSeconds, [&]() {
+        shipment = shipment * 1664525u + 1013904223u;
+        volatile float length = network.FindRoute(depot(shipment >> 8), depot(shipment >> 20)).length;
+        (void)length;
+    });
+    Benchmark("TransportNetwork::FindRoute, search", minSeconds, [&]() {
+        shipment = shipment * 1664525u + 1013904223u;
+        network.ClearRouteCache();
+        volatile float length = network.FindRoute(roadSects[(shipment >> 8) % roadSects.size()]->GetStoreId(),
+                                                  roadSects[(shipment >> 16) % roadSects.size()]->GetStoreId()).length;
+        (void)length;
+    });
+
+    // Draw items as the renderer builds them from a snapshot, for every sect and then culled
+    Colony* drawn = world.colonies[0];
+    std::vector<SectSnapshot> snapshots;
+    for (const auto& sect : drawn->GetSects()) {
+        snapshots.push_back(sect->GetSnapshot());
+    }
+    std::vector<SectDrawItem> drawItems;
+    Benchmark("Sect draw items, all sects", minSeconds, [&]() {
+        drawItems.clear();
+        for (const auto& snapshot : snapshots) {
+            drawItems.push_back(Sect::BuildColonyViewItem(snapshot, 1.0f, 0.5f));
+        }
+    });
+
+    // A 1280x720 screen at zoom 1 centered on the colony: cost follows the screen, not the colony
+    Rectangle screen = {centroid.x - 640.0f, centroid.y - 360.0f, 1280.0f, 720.0f};
+    std::vector<size_t> visibleSects;
+    Benchmark("Sect draw items, culled", minSeconds, [&]() {
+        visibleSects.clear();
+        Colony::CollectVisibleSects(drawn->GetSectGrid(), snapshots.size(), drawn->GetSects().front()->GetRadius(),
+                                    1.0f, screen, 0, visibleSects);
+        drawItems.clear();
+        for (size_t index : visibleSects) {
+            drawItems.push_back(Sect::BuildColonyViewItem(snapshots[index], 1.0f, 0.5f));
+        }
+    });
+}
+
+// Map generation of a 1024x1024-cell and of the largest planet, each with a chunk
+// budget that keeps the whole map resident, on one thread and on the whole pool,
+// then chunk streaming under a view panning across the largest planet
+static void RunMapSuite(double minSeconds) {
+    std::vector<size_t> workerCounts = {0};
+    if (JobSystem::GetDefaultWorkerCount() > 0) {
+        workerCounts.push_back(JobSystem::GetDefaultWorkerCount());
+    }
+    for (int side : {1024, PlanetConfig::MAX_CELLS}) {
+        PlanetConfig config;
+        config.width = config.height = side;
+        const int tileSize = TiledGrid<uint8_t>::TILE_SIZE;
+        config.residentChunks = (side / tileSize) * (side / tileSize);
+        Planet planet(config);
+
+        char name[64];
+        for (size_t workers : workerCounts) {
+            JobSystem::Global().SetWorkerCount(workers);
+            std::snprintf(name, sizeof(name), "Planet::GenerateMap %d, %s", side, workers == 0 ? "1 thread" : "all threads");
+            Benchmark(name, minSeconds, [&]() {
+                planet.GenerateMap();
+            });
+        }
+        std::printf("%zu of %zu chunks generated, %.1f MB\n", planet.GetResidentChunkCount(), planet.GetChunkCount(),
+                    planet.GetMemoryUsage() / 1048576.0);
+    }
+
+    // A 256x144-cell view moving one chunk per step, row by row, with an edit per step
+    PlanetConfig largest;
+    largest.width = largest.height = PlanetConfig::MAX_CELLS;
+    Planet streamed(largest);
+    streamed.GenerateMap();
+    float cellSize = largest.cellSize;
+    int step = 0;
+    const int stepsPerRow = (PlanetConfig::MAX_CELLS - 256) / 64;
+    Benchmark("Planet::StreamChunks, panning", minSeconds, [&]() {
+        int x = step % stepsPerRow * 64;
+        int y = step / stepsPerRow % stepsPerRow * 64;
+        streamed.StreamChunks({x * cellSize, y * cellSize, 256 * cellSize, 144 * cellSize});
+        streamed.SetResourceDeposit({x + 100, y + 70}, Resource::Iron, 1.0f + step % 7);
+        step++;
+    });
+    std::printf("%zu of %zu chunks resident, %.1f MB, chunk file %.1f MB\n", streamed.GetResidentChunkCount(),
+                streamed.GetChunkCount(), streamed.GetMemoryUsage() / 1048576.0, streamed.GetChunkFileSize() / 1048576.0);
+}
+
+// Deposit lookups on the largest planet, with two deposits in every cell of a 1024x1024 region
+static void RunPlanetSuite(double minSeconds) {
+    PlanetConfig config;
+    config.width = config.height = PlanetConfig::MAX_CELLS;
+    Planet planet(config);
+
+    const int region = 1024;
+    for (int y = 0; y < region; y++) {
+        for (int x = 0; x < region; x++) {
+            planet.SetResourceDeposit({x, y}, Resource::Iron, 1.0f + x % 7);
+            planet.SetResourceDeposit({x, y}, Resource::Water, 1.0f + y % 5);
+        }
+    }
+    std::printf("%zu deposits on a %dx%d planet, %.1f MB\n", planet.GetDeposits().GetDepositCount(),
+                config.width, config.height, planet.GetDeposits().GetMemoryUsage() / 1048576.0);
+
+    unsigned pick = 0;
+    volatile float total = 0.0f;
+    Benchmark("Planet::GetResourceInfo", minSeconds, [&]() {
+        pick = pick * 1664525u + 1013904223u;
+        float sum = 0.0f;
+        for (const Deposit& deposit : planet.GetResourceInfo({static_cast<int>((pick >> 8) % region),
+                                                              static_cast<int>((pick >> 20) % region)})) {
+            sum += deposit.amount;
+        }
+        total = sum;
+    });
+
+    // A 64x64-cell extraction area, straddling tiles
+    Benchmark("DepositMap::ForEachInRect 64x64", minSeconds, [&]() {
+        pick = pick * 1664525u + 1013904223u;
+        int x = static_cast<int>((pick >> 8) % (region - 64));
+        int y = static_cast<int>((pick >> 20) % (region - 64));
+        float sum = 0.0f;
+        planet.GetDeposits().ForEachInRect(x, y, x + 63, y + 63, [&sum](int, int, const Deposit& deposit) {
+            sum += deposit.amount;
+        });
+        total = sum;
+    });
+}
+
+// Usage: colony_bench [min_seconds_per_benchmark]
+int main(int argc, char** argv) {
+    double minSeconds = argc > 1 ? std::atof(argv[1]) : 0.25;
+
+    // Timers would be measured along with the code they time
+    Profiler::Global().SetEnabled(false);
+
+    const int sectCounts[] = {1000, 10000, 100000};
+    for (int sectCount : sectCounts) {
+        RunSuite(sectCount, minSeconds);
+    }
+    RunMapSuite(minSeconds);
+    RunPlanetSuite(minSeconds);
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include "Colony/transport_network.h"
+#include "Planet/planet.h"
+#include "profiler.h"
+#include "raymath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <utility>
+
+// Differential checks: an optimized structure and a plain reference take the
+// same seeded random operations, and every answer they disagree on is counted.
+// The runs are reproducible, so a failure can be replayed under a debugger.
+
+// Reports the first few mismatches of a check and counts all of them
+struct Mismatches {
+    size_t count = 0;
+
+    __attribute__((format(printf, 2, 3)))
+    void Report(const char* format, ...) {
+        if (count++ >= 5) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        std::printf("    mismatch: ");
+        std::vprintf(format, args);
+        std::printf("\n");
+        va_end(args);
+    }
+};
+
+static bool SameDeposits(DepositSpan a, DepositSpan b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const Deposit& p, const Deposit& q) {
+        return p.cell == q.cell && p.id == q.id && p.amount == q.amount;
+    });
+}
+
+// Chunk paging on the largest planet with a 64-chunk budget against a copy
+// whose budget holds the whole map: a view jumps around while deposits are
+// edited near it and anywhere on the planet, then every cell is compared
+static size_t CheckChunkPaging() {
+    const int side = PlanetConfig::MAX_CELLS;
+    const int tileSize = TiledGrid<uint8_t>::TILE_SIZE;
+    PlanetConfig residentConfig;
+    residentConfig.width = residentConfig.height = side;
+    residentConfig.seed = 9;
+    residentConfig.residentChunks = (side / tileSize) * (side / tileSize);
+    PlanetConfig pagedConfig = residentConfig;
+    pagedConfig.residentChunks = 64;
+
+    Planet resident(residentConfig);
+    Planet paged(pagedConfig);
+    resident.GenerateMap();
+    paged.GenerateMap();
+
+    std::mt19937 rng(5);
+    Mismatches mismatches;
+    float cellSize = pagedConfig.cellSize;
+    size_t maxResident = 0;
+    for (int step = 0; step < 400; step++) {
+        int viewX = rng() % side;
+        int viewY = rng() % side;
+        float viewWidth = 12.8f * (1 + rng() % 20);
+        float viewHeight = 7.2f * (1 + rng() % 20);
+        paged.StreamChunks({viewX * cellSize, viewY * cellSize, viewWidth * cellSize, viewHeight * cellSize});
+        maxResident = std::max(maxResident, paged.GetResidentChunkCount());
+        if (paged.GetResidentChunkCount() > static_cast<size_t>(pagedConfig.residentChunks)) {
+            mismatches.Report("%zu chunks resident after StreamChunks", paged.GetResidentChunkCount());
+        }
+
+        for (int edit = 0; edit < 50; edit++) {
+            int x = viewX + rng() % 200;
+            int y = viewY + rng() % 200;
+            if (rng() % 4 == 0) {
+                x = rng() % side;
+                y = rng() % side;
+            }
+            ResourceId id = rng() % Resource::BuiltinCount;
+            float amount = rng() % 3 == 0 ? 0.0f : static_cast<float>(rng() % 1000);
+            resident.SetResourceDeposit({x, y}, id, amount);
+            paged.SetResourceDeposit({x, y}, id, amount);
+
+            // Read back a cell that may just have been paged out
+            int readX = rng() % side;
+            int readY = rng() % side;
+            if (!SameDeposits(resident.GetResourceInfo({readX, readY}), paged.GetResourceInfo({readX, readY}))) {
+                mismatches.Report("deposits of cell %d,%d at step %d", readX, readY, step);
+            }
+        }
+    }
+
+    // Row by row, streaming each band of chunks in before reading it
+    for (int y = 0; y < side; y++) {
+        if (y % tileSize == 0) {
+            paged.StreamChunks({0.0f, y * cellSize, side * cellSize, tileSize * cellSize});
+        }
+        for (int x = 0; x < side; x++) {
+            if (resident.GetTerrain({x, y}) != paged.GetTerrain({x, y})) {
+                mismatches.Report("terrain of cell %d,%d", x, y);
+            }
+            if (!SameDeposits(resident.GetResourceInfo({x, y}), paged.GetResourceInfo({x, y}))) {
+                mismatches.Report("deposits of cell %d,%d", x, y);
+            }
+        }
+    }
+
+    std::printf("  %-32s %zu of %zu chunks resident at most, chunk file %.1f MB, %zu mismatches\n",
+                "Chunk paging vs resident", maxResident, paged.GetChunkCount(),
+                paged.GetChunkFileSize() / 1048576.0, mismatches.count);
+    return mismatches.count;
+}
+
+// Road network: the roads as a plain set of node pairs, searched with Dijkstra from scratch
+struct ReferenceRoads {
+    std::vector<Vector2> positions;
+    std::set<std::pair<uint32_t, uint32_t>> roads;  // Lower node first
+
+    static std::pair<uint32_t, uint32_t> Key(uint32_t a, uint32_t b) { return {std::min(a, b), std::max(a, b)}; }
+
+    float Length(uint32_t a, uint32_t b) const { return Vector2Distance(positions[a], positions[b]); }
+
+    // Shortest road distance, infinity when to cannot be reached
+    double Distance(uint32_t from, uint32_t to) const {
+        std::vector<std::vector<uint32_t>> neighbours(positions.size());
+        for (const auto& road : roads) {
+            neighbours[road.first].push_back(road.second);
+            neighbours[road.second].push_back(road.first);
+        }
+
+        typedef std::pair<double, uint32_t> Entry;
+        std::vector<double> distance(positions.size(), INFINITY);
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        distance[from] = 0.0;
+        open.push({0.0, from});
+        while (!open.empty()) {
+            Entry entry = open.top();
+            open.pop();
+            if (entry.first > distance[entry.second]) {
+                continue;
+            }
+            for (uint32_t next : neighbours[entry.second]) {
+                double candidate = entry.first + Length(entry.second, next);
+                if (candidate < distance[next]) {
+                    distance[next] = candidate;
+                    open.push({candidate, next});
+                }
+            }
+        }
+        return distance[to];
+    }
+};
+
+// 20k random road additions, removals, sect removals, sect moves and route
+// queries against the reference. Queries keep to a few dozen sects so most
+// of them hit the route cache, which must have dropped every route a change
+// made stale. A route must run over existing roads and match the shortest
+// distance; the A* lengths are summed in float, hence the tolerance.
+static size_t CheckRoutes() {
+    const uint32_t nodeCount = 300;
+    const uint32_t queriedNodes = 40;
+    std::mt19937 rng(11);
+    TransportNetwork network;
+    ReferenceRoads reference;
+    for (uint32_t node = 0; node < nodeCount; node++) {
+        reference.positions.push_back({static_cast<float>(rng() % 10000), static_cast<float>(rng() % 10000)});
+    }
+
+    Mismatches mismatches;
+    size_t queries = 0;
+    size_t unreachable = 0;
+    for (int step = 0; step < 20000; step++) {
+        uint32_t a = rng() % nodeCount;
+        uint32_t b = rng() % nodeCount;
+        int op = rng() % 12;
+        if (op < 6) {
+            if (a != b && reference.Length(a, b) < 3000.0f) {
+                network.AddRoad(a, reference.positions[a], b, reference.positions[b]);
+                reference.roads.insert(ReferenceRoads::Key(a, b));
+            }
+        } else if (op == 6 && rng() % 3 == 0 && !reference.roads.empty()) {
+            auto road = std::next(reference.roads.begin(), rng() % reference.roads.size());
+            if (!network.RemoveRoad(road->second, road->first)) {
+                mismatches.Report("road %u-%u could not be removed", road->first, road->second);
+            }
+            reference.roads.erase(road);
+        } else if (op == 7 && rng() % 10 == 0) {
+            network.RemoveNode(a);
+            for (auto road = reference.roads.begin(); road != reference.roads.end();) {
+                road = road->first == a || road->second == a ? reference.roads.erase(road) : std::next(road);
+            }
+        } else if (op == 8 && rng() % 10 == 0) {
+            reference.positions[a] = {static_cast<float>(rng() % 10000), static_cast<float>(rng() % 10000)};
+            network.MoveNode(a, reference.positions[a]);
+        } else {
+            for (int query = 0; query < 5; query++) {
+                uint32_t from = rng() % queriedNodes;
+                uint32_t to = rng() % queriedNodes;
+                const TransportNetwork::Route& route = network.FindRoute(from, to);
+                double expected = reference.Distance(from, to);
+                queries++;
+                if (std::isinf(expected)) {
+                    unreachable++;
+                    if (route.IsReachable()) {
+                        mismatches.Report("route %u->%u found, expected none", from, to);
+                    }
+                    continue;
+                }
+
+                bool connected = route.IsReachable() && route.nodes.front() == from && route.nodes.back() == to;
+                double length = 0.0;
+                for (size_t i = 1; connected && i < route.nodes.size(); i++) {
+                    connected = reference.roads.count(ReferenceRoads::Key(route.nodes[i - 1], route.nodes[i])) != 0;
+                    length += reference.Length(route.nodes[i - 1], route.nodes[i]);
+                }
+                double tolerance = 1.0e-3 * expected + 1.0e-2;
+                if (!connected || std::fabs(length - expected) > tolerance ||
+                    std::fabs(route.length - expected) > tolerance) {
+                    mismatches.Report("route %u->%u of length %f, expected %f%s", from, to, route.length, expected,
+                                      connected ? "" : ", not along roads");
+                }
+            }
+        }
+    }
+
+    std::printf("  %-32s %zu queries, %zu unreachable, %zu roads, %zu mismatches\n", "Road routes vs Dijkstra",
+                queries, unreachable, network.GetRoadCount(), mismatches.count);
+    return mismatches.count;
+}
+
+// Usage: colony_check
+int main() {
+    Profiler::Global().SetEnabled(false);
+
+    size_t mismatches = CheckChunkPaging();
+    mismatches += CheckRoutes();
+    std::printf("%s\n", mismatches == 0 ? "All checks passed" : "Checks FAILED");
+    return mismatches == 0 ? 0 : 1;
+}
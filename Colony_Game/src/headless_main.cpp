@@ -0,0 +1,21 @@
+#include "Engine/Engine.h"
+
+#include <cstdlib>
+
+// Screen dimensions (only used to place the initial sect)
+const int screenWidth = 1280;
+const int screenHeight = 720;
+
+// Usage: colony_headless [ticks] [colonies] [sects_per_colony] [trace.json]
+int main(int argc, char** argv) {
+    long ticks = argc > 1 ? std::atol(argv[1]) : 10000;
+    int colonyCount = argc > 2 ? std::atoi(argv[2]) : 0;
+    int sectsPerColony = argc > 3 ? std::atoi(argv[3]) : 1;
+    const char* tracePath = argc > 4 ? argv[4] : nullptr;
+
+    Engine engine(screenWidth, screenHeight, "Colony - Headless", true);
+    engine.InitGame();
+    engine.PopulateWorld(colonyCount, sectsPerColony);
+    engine.RunHeadless(ticks, tracePath);
+    return 0;
+}
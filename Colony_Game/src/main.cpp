@@ -1,11 +1,22 @@
 #include "Engine/Engine.h"
 
+#include <cstdlib>
+
 // Screen dimensions
 const int screenWidth = 1280;
 const int screenHeight = 720;
 
-int main() {
+// Usage: colony_game [planet_cells] [seed]
+int main(int argc, char** argv) {
     Engine engine(screenWidth, screenHeight, "Colony - Planet Colonization Game");
+    if (argc > 1) {
+        PlanetConfig config;
+        config.width = config.height = std::atoi(argv[1]);
+        if (argc > 2) {
+            config.seed = static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10));
+        }
+        engine.ConfigurePlanet(config);
+    }
     engine.InitGame();
     engine.Run();
     return 0;